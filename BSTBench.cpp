@@ -0,0 +1,170 @@
+/*! \file BSTBench.cpp
+ *  \brief Benchmarks for BSTType insertion and node storage.
+ *
+ * Measures the amortized cost of inserting keys in sorted and in random
+ * order, with and without scapegoat rebalancing, for doubling tree sizes.
+ * Without rebalancing, sorted keys build a chain, so the cost per insert
+ * grows with the size of the tree; with rebalancing it should grow only
+ * with its logarithm.
+ *
+ * Then compares the bytes per node and the cost of a lookup by key in a
+ * BSTType, with pointer-linked nodes, and in an IndexBSTType, with 32-bit
+ * index links, both built from the same random keys.
+ *
+ * Usage:
+ *   bstbench [largest size]
+ *
+ * Build:
+ *   g++ -O2 -o bstbench BSTBench.cpp
+ *
+ * \author agent
+ * \date 19-OCT-2026
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <stdlib.h>
+#include "bsttype.h"
+#include "indexbst.h"
+
+using namespace std;
+
+/*! Sorted keys deeper than this are skipped without rebalancing, as the
+ *  recursive insert and destroy follow the whole chain. */
+const int MAX_CHAIN = 32768;
+
+/*! Exposes the key lookup of a BSTType to the benchmark. */
+class BenchBST : public BSTType<int>
+{
+public:
+	using BSTType<int>::IsLeaf;
+};
+
+/*! Looks every key up in a tree, in the given order.
+ *  etval leaves The number of keys held by leaves, so the lookups are used.
+ */
+template <class treeType>
+static long LookUp(const treeType &tree, const vector<int> &keys)
+{
+	long leaves = 0;
+
+	for (size_t i = 0; i < keys.size(); i++)
+		if (const_cast<treeType&>(tree).IsLeaf(keys[i]))
+			leaves++;
+
+	return leaves;
+}
+
+/*! Prints the bytes per node and the cost of a lookup by key for pointer
+ *  and index links.
+ *  \param keys The keys to insert, in order.
+ */
+static void TimeStorage(const vector<int> &keys)
+{
+	BenchBST tree;
+	IndexBSTType<int> indexed;
+	chrono::steady_clock::time_point start;
+	double pointerSeconds;
+	double indexSeconds;
+	long pointerLeaves;
+	long indexLeaves;
+
+	indexed.Reserve(keys.size());
+
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		tree.Insert(keys[i], keys[i]);
+		indexed.Insert(keys[i], keys[i]);
+	}
+
+	start = chrono::steady_clock::now();
+	pointerLeaves = LookUp(tree, keys);
+	pointerSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	start = chrono::steady_clock::now();
+	indexLeaves = LookUp(indexed, keys);
+	indexSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << keys.size() << "\tpointer\t" << sizeof(NodeType<int>)
+		 << "\t" << pointerSeconds / keys.size() * 1e9 << "\t" << pointerLeaves << endl
+		 << keys.size() << "\tindex\t" << IndexBSTType<int>::LinkBytes() + sizeof(int)
+		 << "\t" << indexSeconds / keys.size() * 1e9 << "\t" << indexLeaves << endl;
+}
+
+/*! Inserts keys into a new tree and prints the cost per insert.
+ *  \param keys The keys to insert, in order.
+ *  \param order The name of the key order.
+ *  \param rebalance True to rebalance on insert.
+ */
+static void TimeInserts(const vector<int> &keys, const char *order, bool rebalance)
+{
+	BSTType<int> tree;
+	chrono::steady_clock::time_point start;
+	double seconds;
+
+	tree.SetRebalance(rebalance);
+
+	start = chrono::steady_clock::now();
+
+	for (size_t i = 0; i < keys.size(); i++)
+		tree.Insert(keys[i], keys[i]);
+
+	seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << keys.size() << "\t" << order << "\t" << (rebalance ? "yes" : "no")
+		 << "\t" << seconds / keys.size() * 1e9 << "\t" << tree.Height() << endl;
+}
+
+int main(int argc, char** argv) {
+
+	int largest = (argc > 1) ? atoi(argv[1]) : 262144;
+	vector<int> keys;
+
+	if (largest < 1)
+	{
+		cout << "Usage: bstbench [largest size]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	srand(1);
+
+	cout << "size\torder\trebalance\tns/insert\theight" << endl;
+
+	for (int size = 1024; size <= largest; size *= 2)
+	{
+		keys.resize(size);
+
+		for (int i = 0; i < size; i++)
+			keys[i] = i;
+
+		if (size <= MAX_CHAIN)
+			TimeInserts(keys, "sorted", false);
+
+		TimeInserts(keys, "sorted", true);
+
+		for (int i = size - 1; i > 0; i--)
+			swap(keys[i], keys[rand() % (i + 1)]);
+
+		TimeInserts(keys, "random", false);
+		TimeInserts(keys, "random", true);
+	}
+
+	cout << endl << "size\tlinks\tbytes/node\tns/lookup\tleaves" << endl;
+
+	for (int size = 1024; size <= largest * 8; size *= 8)
+	{
+		keys.resize(size);
+
+		for (int i = 0; i < size; i++)
+			keys[i] = i;
+
+		for (int i = size - 1; i > 0; i--)
+			swap(keys[i], keys[rand() % (i + 1)]);
+
+		TimeStorage(keys);
+	}
+
+	return (EXIT_SUCCESS);
+}
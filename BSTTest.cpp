@@ -0,0 +1,254 @@
+/*! \file BSTTest.cpp
+ *  \brief Tests for BSTType.
+ *
+ * Inserts keys into integer trees in sorted and in random order, with and
+ * without scapegoat rebalancing, and checks after each batch that the
+ * tree holds every key in search order and that a rebalancing tree stays
+ * within its height bound. The same inserts are then made into an
+ * IndexBSTType, which must answer every operation as the BSTType does.
+ *
+ * Usage:
+ *   bsttest
+ *
+ * Build:
+ *   g++ -o bsttest BSTTest.cpp
+ *
+ * The program exits with EXIT_FAILURE if any check fails.
+ *
+ * \author agent
+ * \date 19-OCT-2026
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdlib.h>
+#include "bsttype.h"
+#include "indexbst.h"
+
+using namespace std;
+
+static int failures = 0;                // The number of failed checks
+
+/*! Records a failed check. */
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+static void Check(bool passed, const char *condition, int line)
+{
+	if (!passed)
+	{
+		cout << "Failed: line " << line << ": " << condition << endl;
+		failures++;
+	}
+}
+
+/*! Exposes the nodes of a BSTType to the tests. */
+class TestBST : public BSTType<int>
+{
+public:
+	using BSTType<int>::IsLeaf;
+	using BSTType<int>::Navigate;
+
+	/*! Returns true if every node holds its own key as info, the keys are
+	 *  in search order, and the tree holds Size() nodes. */
+	bool Valid() const
+	{
+		vector< NodeType<int>* > pending;
+		NodeType<int> *node = root;
+		int previous = 0;
+		int count = 0;
+
+		/* An inorder walk must meet the keys in increasing order */
+		while (node != NULL || !pending.empty())
+		{
+			for (; node != NULL; node = node->lLink)
+				pending.push_back(node);
+
+			node = pending.back();
+			pending.pop_back();
+
+			if ((count > 0 && node->key <= previous) || node->info != node->key)
+				return false;
+
+			previous = node->key;
+			count++;
+			node = node->rLink;
+		}
+
+		return (count == Size());
+	}
+};
+
+/*! Returns the height a rebalancing tree of a given size may not exceed. */
+static int HeightBound(int size, double balance)
+{
+	return (int) floor(log((double) size + 1) / log(1.0 / balance)) + 1;
+}
+
+/*! Returns the height of a perfectly balanced tree of a given size. */
+static int BalancedHeight(int size)
+{
+	int height = 0;
+
+	for (; size > 0; size /= 2)
+		height++;
+
+	return height;
+}
+
+static void TestSetRebalance()
+{
+	TestBST tree;
+
+	CHECK(!tree.SetRebalance(true, 0.5));
+	CHECK(!tree.SetRebalance(true, 1.0));
+	CHECK(!tree.SetRebalance(true, numeric_limits<double>::quiet_NaN()));
+	CHECK(tree.SetRebalance(true, 0.6));
+	CHECK(tree.SetRebalance(false));
+}
+
+static void TestInserts(const vector<int> &keys, bool rebalance, double balance)
+{
+	TestBST tree;
+	bool bounded = true;
+	bool valid = true;
+	size_t i;
+
+	tree.SetRebalance(rebalance, balance);
+
+	for (i = 0; i < keys.size(); i++)
+	{
+		tree.Insert(keys[i], keys[i]);
+
+		if (rebalance && tree.Height() > HeightBound(tree.Size(), balance))
+			bounded = false;
+
+		/* Checking every insert would be quadratic, so check at powers of two */
+		if (((i + 1) & i) == 0)
+			valid = tree.Valid() && valid;
+	}
+
+	CHECK(bounded);
+	CHECK(valid && tree.Valid());
+	CHECK(tree.Size() == (int) keys.size());
+
+	/* A duplicate key is rejected and leaves the tree unchanged */
+	tree.Insert(keys[0], keys[0]);
+	CHECK(tree.Size() == (int) keys.size());
+
+	tree.Rebalance();
+	CHECK(tree.Valid());
+	CHECK(tree.Height() == BalancedHeight(tree.Size()));
+}
+
+static void TestDegenerate()
+{
+	TestBST tree;
+
+	for (int key = 0; key < 100; key++)
+		tree.Insert(key, key);
+
+	/* Without rebalancing, sorted keys form a chain */
+	CHECK(tree.Height() == 100);
+	CHECK(tree.Valid());
+}
+
+static void TestIndexStorage(const vector<int> &keys, bool rebalance)
+{
+	TestBST tree;
+	IndexBSTType<int> indexed;
+	bool same = true;
+	int found;
+	int indexFound;
+	int key;
+	int indexKey;
+	bool navigated;
+
+	tree.SetRebalance(rebalance);
+	indexed.SetRebalance(rebalance);
+
+	CHECK(indexed.IsEmpty() && indexed.Height() == 0);
+
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		tree.Insert(keys[i], keys[i]);
+		indexed.Insert(keys[i], keys[i]);
+	}
+
+	indexed.Insert(keys[0], keys[0]);
+
+	CHECK(!indexed.IsEmpty());
+	CHECK(indexed.Size() == tree.Size());
+	CHECK(indexed.Height() == tree.Height());
+
+	/* Equal shapes give every key the same children */
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		for (int direction = LEFT_LINK; direction <= RIGHT_LINK; direction++)
+		{
+			found = indexFound = key = indexKey = -1;
+			navigated = tree.Navigate(keys[i], found, key, direction);
+
+			if (   navigated != indexed.Navigate(keys[i], indexFound, indexKey, direction)
+				|| found != indexFound || key != indexKey)
+				same = false;
+		}
+
+		if (tree.IsLeaf(keys[i]) != indexed.IsLeaf(keys[i]))
+			same = false;
+	}
+
+	CHECK(same);
+	CHECK(indexed.Search(keys[keys.size() / 2], indexKey) && indexKey == keys[keys.size() / 2]);
+	CHECK(!indexed.Search(-1, indexKey));
+	CHECK(indexed.ReplaceInfo(keys[0], -5) && indexed.Search(-5, indexKey) && indexKey == keys[0]);
+	CHECK(!indexed.ReplaceInfo(-1, -5));
+
+	tree.Rebalance();
+	indexed.Rebalance();
+	CHECK(indexed.Height() == tree.Height());
+	CHECK(IndexBSTType<int>::LinkBytes() == 12);
+}
+
+int main() {
+
+	vector<int> keys(2048);
+
+	TestSetRebalance();
+	TestDegenerate();
+
+	for (size_t i = 0; i < keys.size(); i++)
+		keys[i] = (int) i;
+
+	TestInserts(keys, true, DEFAULT_BALANCE);
+	TestInserts(keys, true, 0.55);
+
+	reverse(keys.begin(), keys.end());
+	TestInserts(keys, true, DEFAULT_BALANCE);
+
+	srand(1);
+
+	for (size_t i = keys.size() - 1; i > 0; i--)
+		swap(keys[i], keys[rand() % (i + 1)]);
+
+	TestInserts(keys, false, DEFAULT_BALANCE);
+	TestInserts(keys, true, DEFAULT_BALANCE);
+	TestInserts(keys, true, 0.9);
+
+	TestIndexStorage(keys, false);
+	TestIndexStorage(keys, true);
+
+	sort(keys.begin(), keys.end());
+	TestIndexStorage(keys, true);
+
+	if (failures != 0)
+	{
+		cout << failures << " checks failed." << endl;
+		return (EXIT_FAILURE);
+	}
+
+	cout << "All checks passed." << endl;
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,188 @@
+/*! \file QALearnQueueTest.cpp
+ *  \brief Stress test for QALearnQueue.
+ *
+ * Worker threads submit learned questions on disjoint leaves of a shared
+ * tree while a writer thread drains the queue, then every question is
+ * checked to have been learned exactly once, in the right place.
+ *
+ * Usage:
+ *   qalearnqueuetest [threads] [learns per thread] [rounds]
+ *       threads - The number of submitting threads (default 16).
+ *       learns per thread - The questions each thread submits (default 256).
+ *       rounds - The number of times the test is repeated (default 20).
+ *
+ * Build:
+ *   g++ -std=c++11 -pthread -o qalearnqueuetest QALearnQueueTest.cpp qatree.cpp qalearnqueue.cpp
+ *
+ * The program exits with EXIT_FAILURE if any check fails.
+ *
+ * \author agent
+ * \date 19-OCT-2026
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <stdlib.h>
+#include "qatree.h"
+#include "qalearnqueue.h"
+
+using namespace std;
+
+static int failures = 0;                // The number of failed checks
+
+/*! Records a failed check. */
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+static void Check(bool passed, const char *condition, int line)
+{
+	if (!passed)
+	{
+		cout << "Failed: line " << line << ": " << condition << endl;
+		failures++;
+	}
+}
+
+/*! Returns the text of a numbered object. */
+static string Object(const char *prefix, int i)
+{
+	ostringstream text;
+
+	text << prefix << i;
+	return text.str();
+}
+
+/*! Builds a balanced tree whose answers are object0 to object(count - 1).
+ *  \param tree An empty tree.
+ *  \param count The number of answers, a power of two.
+ */
+static void BuildTree(QATree &tree, int count)
+{
+	vector<QALearnRecord> records;
+	vector<int> conflicts;
+	QALearnRecord record;
+
+	record.question = "Is it object1?";
+	record.answer = "object1";
+	record.alternateQA = "object0";
+	tree.LearnBatch(vector<QALearnRecord>(1, record), conflicts);
+
+	/* Each round splits every answer into two */
+	for (int size = 2; size < count; size *= 2)
+	{
+		records.clear();
+
+		for (int i = 0; i < size; i++)
+		{
+			record.question = "Is it " + Object("object", i + size) + "?";
+			record.answer = Object("object", i + size);
+			record.alternateQA = Object("object", i);
+			records.push_back(record);
+		}
+
+		tree.LearnBatch(records, conflicts);
+	}
+}
+
+static void StressRound(int threads, int learns)
+{
+	QATree tree;
+	QALearnQueue queue(tree);
+	vector<thread> workers;
+	vector<QALearnRecord> conflicts;
+	atomic<int> running(threads);
+	int applied = 0;
+	int rejected = 0;
+	int initialSize;
+	int learned = 0;
+	int key;
+	stringstream saved;
+	vector<string> lines;
+	string text;
+	bool placed = true;
+
+	BuildTree(tree, threads * learns);
+	initialSize = tree.Size();
+
+	/* Worker t learns below every answer numbered t modulo threads */
+	for (int t = 0; t < threads; t++)
+	{
+		workers.push_back(thread([&queue, &running, t, threads, learns]()
+		{
+			QALearnRecord record;
+
+			for (int i = t; i < threads * learns; i += threads)
+			{
+				record.question = "Is it like " + Object("object", i) + "?";
+				record.answer = Object("new", i);
+				record.alternateQA = Object("object", i);
+				queue.Submit(record);
+			}
+
+			running--;
+		}));
+	}
+
+	/* The writer drains while the workers are still submitting */
+	while (running > 0 || queue.Pending() > 0)
+	{
+		applied += queue.Drain(conflicts);
+		rejected += (int) conflicts.size();
+	}
+
+	for (int t = 0; t < threads; t++)
+		workers[t].join();
+
+	CHECK(applied == threads * learns);
+	CHECK(rejected == 0);
+	CHECK(tree.Size() == initialSize + 2 * applied);
+
+	/* In preorder, each learned question is followed by its no and yes answers */
+	saved << tree;
+
+	while (saved >> key && getline(saved, text))
+		lines.push_back(text.substr(1));
+
+	for (size_t i = 0; i + 2 < lines.size(); i++)
+	{
+		if (lines[i].compare(0, 11, "Is it like ") == 0)
+		{
+			learned++;
+			placed = placed && "Is it like " + lines[i + 1] + "?" == lines[i]
+			                && "new" + lines[i + 1].substr(6) == lines[i + 2];
+		}
+	}
+
+	CHECK(learned == applied);
+	CHECK(placed);
+}
+
+int main(int argc, char** argv) {
+
+	int threads = (argc > 1) ? atoi(argv[1]) : 16;
+	int learns = (argc > 2) ? atoi(argv[2]) : 256;
+	int rounds = (argc > 3) ? atoi(argv[3]) : 20;
+
+	/* Answers are split evenly between threads, so both must be powers of two */
+	if (threads < 1 || learns < 1 || ((threads * learns) & (threads * learns - 1)) != 0)
+	{
+		cout << "Usage: qalearnqueuetest [threads] [learns per thread] [rounds]" << endl
+			 << "       threads times learns per thread must be a power of two" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	for (int round = 0; round < rounds && failures == 0; round++)
+		StressRound(threads, learns);
+
+	if (failures != 0)
+	{
+		cout << failures << " checks failed." << endl;
+		return (EXIT_FAILURE);
+	}
+
+	cout << "All checks passed." << endl;
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,672 @@
+/*! \file QATreeBench.cpp
+ *  \brief Benchmarks for QATree.
+ *
+ * Each mode times one QATree facility against the path it replaces.
+ *
+ * Usage:
+ *   qatreebench generate <tree file> <answers>
+ *       Writes a balanced tree of the given number of answers.
+ *   qatreebench compiled <tree file> [walks]
+ *       Compares a tree compiled by qacompile with the same tree loaded
+ *       at run time. Requires the tree to be compiled into benchtree.h
+ *       and the benchmark built with -DBENCH_COMPILED_TREE:
+ *         qacompile tree.txt benchtree.h benchTree
+ *         g++ -std=c++11 -O2 -pthread -DBENCH_COMPILED_TREE -o qatreebench \
+ *             QATreeBench.cpp qatree.cpp qalearnqueue.cpp qaloader.cpp
+ *   qatreebench classify [answers] [walks]
+ *       Times ClassifyBatch over random walks through a balanced tree, with
+ *       the walks split into one range per thread, from 1 thread up to the
+ *       number of hardware threads.
+ *   qatreebench hotpath [answers] [hot paths] [walks]
+ *       Times walks that follow a few hot paths through a large tree laid
+ *       out in level order, as a tree grown by learning is, then again
+ *       after Recluster in plain preorder and with the hot nodes first.
+ *       Walks are timed through ClassifyBatch and through the key
+ *       overloads of GetFirstQA, GetNextQA and IsAnswer, as a player's
+ *       are, with the visit counts gathered by GetNextQA itself, and the
+ *       cost of counting every visit and one in VISIT_SAMPLE is reported.
+ *       The text overload of GetNextQA searches every node at each step,
+ *       which no layout helps, so it is not timed here.
+ *   qatreebench load <tree file>
+ *       Times loading a tree file through LoadRecords on one thread, then
+ *       through QALoader, which reads ahead on a second thread, first from
+ *       the page cache and then with the file evicted from it before each
+ *       load, so that it is read from disk.
+ *   qatreebench learn [answers] [learns]
+ *       Times learns on disjoint leaves submitted from 1 to 32 threads,
+ *       first with each learn applied by CreateQuestionAnswer under one
+ *       mutex, then through a QALearnQueue drained by a writer thread.
+ *       Either way one thread applies every learn, so neither scales with
+ *       threads; the table shows what batching saves over single learns
+ *       and what contention costs as threads are added.
+ *
+ * Build (all modes other than compiled):
+ *   g++ -std=c++11 -O2 -pthread -o qatreebench QATreeBench.cpp qatree.cpp qalearnqueue.cpp \
+ *       qaloader.cpp
+ *
+ * \author agent
+ * \date 19-OCT-2026
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "qatree.h"
+#include "qalearnqueue.h"
+#include "qaloader.h"
+
+#ifdef BENCH_COMPILED_TREE
+#include "benchtree.h"
+#endif
+
+using namespace std;
+
+/*! Walks timed through GetNextQA, which searches the tree by text each step */
+const long PLAY_WALKS = 20;
+
+/*! One visit in this many is counted by sampled counting */
+const unsigned int VISIT_SAMPLE = 16;
+
+/*! Exposes the nodes of a QATree to the benchmarks. */
+class BenchTree : public QATree
+{
+public:
+	/*! Writes the tree as "key text" records in level order.
+	 *  \param output The stream receiving the records.
+	 */
+	void WriteLevelOrder(ostream &output) const
+	{
+		vector<const StringNode*> level(1, root);
+
+		for (size_t i = 0; root != NULL && i < level.size(); i++)
+		{
+			output << level[i]->key << ' ' << level[i]->info << '\n';
+
+			if (level[i]->lLink != NULL)
+				level.push_back(level[i]->lLink);
+
+			if (level[i]->rLink != NULL)
+				level.push_back(level[i]->rLink);
+		}
+	}
+};
+
+/*! Returns the seconds elapsed since a start time. */
+static double Elapsed(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/*! Writes a balanced subtree in preorder, numbering keys in key order.
+ *  \param output The stream receiving the records.
+ *  \param first The index of the first answer in the subtree.
+ *  \param count The number of answers in the subtree.
+ *  \param key The key of the leftmost node in the subtree.
+ */
+static void GenerateNodes(ostream &output, long first, long count, long key)
+{
+	long noCount = count / 2;
+
+	if (count == 1)
+	{
+		output << key << " object" << first << '\n';
+		return;
+	}
+
+	/* The no subtree holds 2 * noCount - 1 nodes, each 2 keys apart */
+	output << key + 2 * (2 * noCount - 1) << " Is it one of objects " << first
+		   << " to " << first + noCount - 1 << "?" << '\n';
+
+	GenerateNodes(output, first, noCount, key);
+	GenerateNodes(output, first + noCount, count - noCount, key + 2 * (2 * noCount));
+}
+
+/*! Returns random y/n answer sets long enough to reach any answer.
+ *  \param walks The number of answer sets.
+ *  \param depth The length of each answer set.
+ */
+static vector<string> RandomAnswerSets(long walks, int depth)
+{
+	vector<string> answerSets(walks, string(depth, 'n'));
+
+	srand(1);
+
+	for (long w = 0; w < walks; w++)
+		for (int d = 0; d < depth; d++)
+			if (rand() & 1)
+				answerSets[w][d] = 'y';
+
+	return answerSets;
+}
+
+static int Generate(const string &fname, long answers)
+{
+	ofstream ofile(fname.c_str());
+
+	if (!ofile || answers < 1)
+		return (EXIT_FAILURE);
+
+	GenerateNodes(ofile, 0, answers, 0);
+	ofile.close();
+
+	return ofile.fail() ? (EXIT_FAILURE) : (EXIT_SUCCESS);
+}
+
+#ifndef BENCH_COMPILED_TREE
+static int Compiled(const string &, long)
+{
+	cout << "Error: Build with -DBENCH_COMPILED_TREE and a generated benchtree.h" << endl;
+	return (EXIT_FAILURE);
+}
+#else
+static int Compiled(const string &fname, long walks)
+{
+	QATree qatree;
+	vector<string> answerSets;
+	vector<const StringNode*> leaves;
+	string question;
+	string answer;
+	long playWalks = (walks < PLAY_WALKS) ? walks : PLAY_WALKS;
+	long mismatches = 0;
+	double seconds;
+	int node;
+	size_t d;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	ifstream ifile(fname.c_str());
+
+	if (!ifile)
+		return (EXIT_FAILURE);
+
+	qatree.LoadRecords(ifile);
+	seconds = Elapsed(start);
+
+	cout << "nodes:                 " << qatree.Size() << endl
+		 << "dynamic load:          " << seconds * 1e3 << " ms" << endl
+		 << "compiled load:         0 ms (static data)" << endl;
+
+	answerSets = RandomAnswerSets(walks, qatree.Height());
+	leaves.resize(walks);
+
+	/* Link-following walks over the heap nodes */
+	start = chrono::steady_clock::now();
+	qatree.ClassifyBatch(answerSets, 0, walks, &leaves[0]);
+	seconds = Elapsed(start);
+	cout << "dynamic ClassifyBatch: " << seconds / walks * 1e9 << " ns/walk" << endl;
+
+	/* The play path searches by text at every step, so only a sample is timed */
+	start = chrono::steady_clock::now();
+
+	for (long w = 0; w < playWalks; w++)
+	{
+		qatree.GetFirstQA(question);
+
+		for (d = 0; !qatree.IsAnswer(question); d++)
+		{
+			qatree.GetNextQA(question, answer,
+				(answerSets[w][d] == 'y') ? CORRECT_PATH : INCORRECT_PATH);
+			question = answer;
+		}
+
+		if (question != leaves[w]->info)
+			mismatches++;
+	}
+
+	seconds = Elapsed(start);
+	cout << "dynamic GetNextQA:     " << seconds / playWalks * 1e9 << " ns/walk" << endl;
+
+	/* Index-following walks over the static table */
+	start = chrono::steady_clock::now();
+
+	for (long w = 0; w < walks; w++)
+	{
+		node = 0;
+
+		for (d = 0; !CompiledIsAnswer(benchTree, node); d++)
+			node = CompiledNextQA(benchTree, node,
+				(answerSets[w][d] == 'y') ? CORRECT_PATH : INCORRECT_PATH);
+
+		if (leaves[w]->info != benchTree[node].text)
+			mismatches++;
+	}
+
+	seconds = Elapsed(start);
+	cout << "compiled table:        " << seconds / walks * 1e9 << " ns/walk" << endl;
+
+	/* Every path must reach the same answers */
+	if (mismatches != 0)
+		cout << "Error: " << mismatches << " walks reached different answers" << endl;
+
+	return (mismatches == 0) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+}
+#endif
+
+/*! Returns the fastest of several timed ClassifyBatch runs, in ns per walk.
+ *  \param tree The tree to walk.
+ *  \param walks The answer sets of the walks.
+ */
+static double TimeWalks(const QATree &tree, const vector<string> &walks)
+{
+	vector<const StringNode*> leaves(walks.size());
+	chrono::steady_clock::time_point start;
+	double best = 0;
+
+	for (int run = 0; run < 3; run++)
+	{
+		start = chrono::steady_clock::now();
+		tree.ClassifyBatch(walks, 0, walks.size(), &leaves[0]);
+
+		if (run == 0 || Elapsed(start) < best)
+			best = Elapsed(start);
+	}
+
+	return best / walks.size() * 1e9;
+}
+
+/*! Returns the fastest of several timed runs of walks played through the
+ *  key overloads of GetFirstQA, GetNextQA and IsAnswer, in ns per walk.
+ *  \param tree The tree to walk.
+ *  \param walks The answer sets of the walks.
+ */
+static double TimePlay(QATree &tree, const vector<string> &walks)
+{
+	chrono::steady_clock::time_point start;
+	string question;
+	string answer;
+	double best = 0;
+	int key;
+
+	for (int run = 0; run < 3; run++)
+	{
+		start = chrono::steady_clock::now();
+
+		for (size_t w = 0; w < walks.size(); w++)
+		{
+			tree.GetFirstQA(question, key);
+
+			for (size_t d = 0; !tree.IsAnswer(question, key) && d < walks[w].size(); d++)
+			{
+				tree.GetNextQA(question, key, answer,
+					(walks[w][d] == 'y') ? CORRECT_PATH : INCORRECT_PATH);
+				question.swap(answer);
+			}
+		}
+
+		if (run == 0 || Elapsed(start) < best)
+			best = Elapsed(start);
+	}
+
+	return best / walks.size() * 1e9;
+}
+
+static int Classify(long answers, long walks)
+{
+	QATree tree;
+	stringstream records;
+	vector<string> answerSets;
+	vector<const StringNode*> leaves;
+	vector<int> classified;
+	chrono::steady_clock::time_point start;
+	int cores = (int) thread::hardware_concurrency();
+	int total;
+
+	if (answers < 2 || walks < 1)
+		return (EXIT_FAILURE);
+
+	GenerateNodes(records, 0, answers, 0);
+	tree.LoadRecords(records);
+	answerSets = RandomAnswerSets(walks, tree.Height());
+	leaves.resize(walks);
+
+	cout << "nodes:                 " << tree.Size() << endl
+		 << "threads\tclassifications/s" << endl;
+
+	for (int threads = 1; threads == 1 || threads <= cores; threads *= 2)
+	{
+		vector<thread> workers;
+
+		classified.assign(threads, 0);
+		start = chrono::steady_clock::now();
+
+		/* Each thread classifies its own range into the shared leaves */
+		for (int t = 0; t < threads; t++)
+		{
+			workers.push_back(thread([&tree, &answerSets, &leaves, &classified, t, threads, walks]()
+			{
+				classified[t] = tree.ClassifyBatch(answerSets, walks * t / threads,
+				                                   walks * (t + 1) / threads, &leaves[0]);
+			}));
+		}
+
+		for (int t = 0; t < threads; t++)
+			workers[t].join();
+
+		cout << threads << "\t" << walks / Elapsed(start) << endl;
+
+		total = 0;
+
+		for (int t = 0; t < threads; t++)
+			total += classified[t];
+
+		if (total != walks)
+		{
+			cout << "Error: " << walks - total << " walks reached no answer" << endl;
+			return (EXIT_FAILURE);
+		}
+	}
+
+	return (EXIT_SUCCESS);
+}
+
+static int HotPath(long answers, long hotPaths, long walks)
+{
+	BenchTree tree;
+	vector<string> hot;
+	vector<string> hotWalks;
+	stringstream records;
+
+	if (answers < 2 || hotPaths < 1 || walks < 1)
+		return (EXIT_FAILURE);
+
+	/* Loading in level order places each level of the tree apart from the next */
+	{
+		BenchTree preorder;
+
+		GenerateNodes(records, 0, answers, 0);
+		preorder.LoadRecords(records);
+
+		records.clear();
+		records.str("");
+		preorder.WriteLevelOrder(records);
+	}
+
+	tree.LoadRecords(records);
+	records.str("");
+
+	hot = RandomAnswerSets(hotPaths, tree.Height());
+
+	for (long w = 0; w < walks; w++)
+		hotWalks.push_back(hot[rand() % hotPaths]);
+
+	cout << "nodes:                 " << tree.Size() << endl
+		 << "hot paths:             " << hotPaths << endl
+		 << "GetNextQA, uncounted:  " << TimePlay(tree, hotWalks) << " ns/walk" << endl;
+
+	/* The counts that place the hot nodes come from the play path itself */
+	tree.SetVisitCounting(true, VISIT_SAMPLE);
+	cout << "counting 1 in " << VISIT_SAMPLE << ":      " << TimePlay(tree, hotWalks) << " ns/walk" << endl;
+
+	tree.SetVisitCounting(true);
+	cout << "counting every visit:  " << TimePlay(tree, hotWalks) << " ns/walk" << endl;
+
+	tree.SetVisitCounting(false);
+	cout << endl << "ns/walk           ClassifyBatch  GetNextQA" << endl << fixed << setprecision(0)
+		 << "level order       " << setw(13) << TimeWalks(tree, hotWalks)
+		 << setw(11) << TimePlay(tree, hotWalks) << endl;
+
+	tree.Recluster(0);
+	cout << "preorder          " << setw(13) << TimeWalks(tree, hotWalks)
+		 << setw(11) << TimePlay(tree, hotWalks) << endl;
+
+	tree.Recluster();
+	cout << "hot nodes first   " << setw(13) << TimeWalks(tree, hotWalks)
+		 << setw(11) << TimePlay(tree, hotWalks) << endl;
+
+	return (EXIT_SUCCESS);
+}
+
+/*! Evicts a file from the page cache, so that the next read is from disk.
+ *  \retval true If the file was evicted.
+ */
+static bool Evict(const string &fname)
+{
+	int fd = open(fname.c_str(), O_RDONLY);
+	bool evicted;
+
+	if (fd < 0)
+		return false;
+
+	evicted = (fdatasync(fd) == 0 && posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0);
+	close(fd);
+
+	return evicted;
+}
+
+/*! Loads a tree file into an empty tree.
+ *  \param fname The tree file.
+ *  \param pipelined True to load through QALoader, false through LoadRecords.
+ *  \param cold True to evict the file from the page cache first.
+ *  \retval size The number of nodes loaded.
+ *  \retval seconds The time taken, or -1 if the load failed.
+ */
+static double TimeLoad(const string &fname, bool pipelined, bool cold, int &size)
+{
+	QATree tree;
+	QALoader loader;
+	chrono::steady_clock::time_point start;
+
+	if (cold && !Evict(fname))
+		return -1;
+
+	start = chrono::steady_clock::now();
+
+	if (pipelined)
+	{
+		if (!loader.Load(tree, fname))
+			return -1;
+	}
+	else
+	{
+		ifstream ifile(fname.c_str(), ios::binary);
+
+		if (!ifile)
+			return -1;
+
+		tree.LoadRecords(ifile);
+	}
+
+	size = tree.Size();
+	return Elapsed(start);
+}
+
+static int Load(const string &fname)
+{
+	double best[2];
+	double seconds;
+	int size = 0;
+	int expected = -1;
+
+	for (int cold = 0; cold < 2; cold++)
+	{
+		/* Each loader goes first in turn; the best of three loads is kept */
+		for (int run = 0; run < 6; run++)
+		{
+			bool pipelined = ((run + run / 2) % 2 == 1);
+
+			seconds = TimeLoad(fname, pipelined, cold == 1, size);
+
+			if (seconds < 0 || (expected >= 0 && size != expected))
+			{
+				cout << "Error: Unable to load " << fname << endl;
+				return (EXIT_FAILURE);
+			}
+
+			expected = size;
+
+			if (run < 2 || seconds < best[pipelined])
+				best[pipelined] = seconds;
+		}
+
+		if (cold == 0)
+			cout << "nodes:                 " << size << endl;
+
+		cout << (cold ? "from disk" : "from cache") << endl
+			 << "  LoadRecords:         " << best[0] * 1e3 << " ms" << endl
+			 << "  QALoader:            " << best[1] * 1e3 << " ms" << endl;
+	}
+
+	return (EXIT_SUCCESS);
+}
+
+/*! Returns the learn that a worker submits for an answer. */
+static QALearnRecord LearnRecord(long answer)
+{
+	QALearnRecord record;
+	ostringstream text;
+
+	text << answer;
+	record.question = "Is it like object" + text.str() + "?";
+	record.answer = "new" + text.str();
+	record.alternateQA = "object" + text.str();
+
+	return record;
+}
+
+/*! Learns on disjoint answers from several threads, one at a time through
+ *  CreateQuestionAnswer under one mutex.
+ *  \retval seconds The time taken.
+ */
+static double LearnLocked(QATree &tree, int threads, long learns)
+{
+	vector<thread> workers;
+	mutex treeLock;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	for (int t = 0; t < threads; t++)
+	{
+		workers.push_back(thread([&tree, &treeLock, t, threads, learns]()
+		{
+			QALearnRecord record;
+
+			for (long i = t; i < learns; i += threads)
+			{
+				record = LearnRecord(i);
+				lock_guard<mutex> guard(treeLock);
+
+				tree.CreateQuestionAnswer(record.question, record.answer, record.alternateQA);
+			}
+		}));
+	}
+
+	for (int t = 0; t < threads; t++)
+		workers[t].join();
+
+	return Elapsed(start);
+}
+
+/*! Learns on disjoint answers from several threads through a learn queue.
+ *  \retval seconds The time taken.
+ */
+static double LearnQueued(QATree &tree, int threads, long learns)
+{
+	QALearnQueue queue(tree);
+	vector<thread> workers;
+	vector<QALearnRecord> conflicts;
+	atomic<int> running(threads);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	for (int t = 0; t < threads; t++)
+	{
+		workers.push_back(thread([&queue, &running, t, threads, learns]()
+		{
+			for (long i = t; i < learns; i += threads)
+				queue.Submit(LearnRecord(i));
+
+			running--;
+		}));
+	}
+
+	while (running > 0 || queue.Pending() > 0)
+		queue.Drain(conflicts);
+
+	for (int t = 0; t < threads; t++)
+		workers[t].join();
+
+	return Elapsed(start);
+}
+
+static int Learn(long answers, long learns)
+{
+	stringstream records;
+	string saved;
+	double seconds;
+
+	if (answers < 2 || learns < 1 || learns > answers)
+		return (EXIT_FAILURE);
+
+	GenerateNodes(records, 0, answers, 0);
+	saved = records.str();
+
+	cout << "threads\tmutex learns/s\tqueue learns/s" << endl;
+
+	for (int threads = 1; threads <= 32; threads *= 2)
+	{
+		QATree locked;
+		QATree queued;
+		istringstream lockedRecords(saved);
+		istringstream queuedRecords(saved);
+
+		locked.LoadRecords(lockedRecords);
+		queued.LoadRecords(queuedRecords);
+
+		seconds = LearnLocked(locked, threads, learns);
+		cout << threads << "\t" << learns / seconds;
+
+		seconds = LearnQueued(queued, threads, learns);
+		cout << "\t" << learns / seconds << endl;
+
+		if (locked.Size() != queued.Size() || locked.Size() != (int) (2 * answers - 1 + 2 * learns))
+		{
+			cout << "Error: Learns were lost" << endl;
+			return (EXIT_FAILURE);
+		}
+	}
+
+	return (EXIT_SUCCESS);
+}
+
+int main(int argc, char** argv) {
+
+	string mode = (argc > 1) ? argv[1] : "";
+
+	if (mode == "generate" && argc == 4)
+		return Generate(argv[2], atol(argv[3]));
+
+	if (mode == "compiled" && (argc == 3 || argc == 4))
+		return Compiled(argv[2], (argc == 4) ? atol(argv[3]) : 1000);
+
+	if (mode == "classify" && argc <= 4)
+		return Classify((argc > 2) ? atol(argv[2]) : 1 << 20,
+		                (argc > 3) ? atol(argv[3]) : 4000000);
+
+	if (mode == "hotpath" && argc <= 5)
+		return HotPath((argc > 2) ? atol(argv[2]) : 1 << 19,
+		               (argc > 3) ? atol(argv[3]) : 4096,
+		               (argc > 4) ? atol(argv[4]) : 1000000);
+
+	if (mode == "load" && argc == 3)
+		return Load(argv[2]);
+
+	if (mode == "learn" && argc <= 4)
+		return Learn((argc > 2) ? atol(argv[2]) : 1 << 15,
+		             (argc > 3) ? atol(argv[3]) : 4096);
+
+	cout << "Usage: qatreebench generate <tree file> <answers>" << endl
+		 << "       qatreebench compiled <tree file> [walks]" << endl
+		 << "       qatreebench classify [answers] [walks]" << endl
+		 << "       qatreebench hotpath [answers] [hot paths] [walks]" << endl
+		 << "       qatreebench load <tree file>" << endl
+		 << "       qatreebench learn [answers] [learns]" << endl;
+
+	return (EXIT_FAILURE);
+}
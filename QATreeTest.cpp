@@ -0,0 +1,710 @@
+/*! \file QATreeTest.cpp
+ *  \brief Tests for QATree.
+ *
+ * Runs functional checks of the QATree interface, then checks that the
+ * query functions used during play make no heap allocations. Every
+ * allocation made through the global operator new is counted.
+ *
+ * Usage:
+ *   qatreetest [rounds]
+ *       rounds - The number of times each query is repeated while
+ *                allocations are counted (default 1000000).
+ *
+ * Build:
+ *   g++ -std=c++11 -pthread -o qatreetest QATreeTest.cpp qatree.cpp qaforest.cpp \
+ *       qaloader.cpp qaimage.cpp qasnapshot.cpp qafile.cpp
+ *
+ * The program exits with EXIT_FAILURE if any check fails.
+ *
+ * \author agent
+ * \date 19-OCT-2026
+ */
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <new>
+#include <stdlib.h>
+#include <stdio.h>
+#include "qatree.h"
+#include "qaforest.h"
+#include "qaloader.h"
+#include "qaimage.h"
+#include "qasnapshot.h"
+
+using namespace std;
+
+static long allocations = 0;            // The number of calls to operator new
+static int failures = 0;                // The number of failed checks
+
+void* operator new(size_t size)
+{
+	void *p = malloc(size ? size : 1);
+
+	if (p == NULL)
+		throw bad_alloc();
+
+	allocations++;
+	return p;
+}
+
+void operator delete(void *p) throw()
+{
+	free(p);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void *p, size_t) throw()
+{
+	free(p);
+}
+#endif
+
+/*! Records a failed check. */
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+static void Check(bool passed, const char *condition, int line)
+{
+	if (!passed)
+	{
+		cout << "Failed: line " << line << ": " << condition << endl;
+		failures++;
+	}
+}
+
+/*! Exposes the protected key functions of a QATree to the tests. */
+class TestTree : public QATree
+{
+public:
+	using QATree::IsLeaf;
+	using QATree::Navigate;
+
+	/*! Returns the visits counted for a key. */
+	unsigned int Visits(int key) const
+	{
+		return FindKey(key)->visits;
+	}
+};
+
+/*! Builds the tree used by the tests:
+ *
+ *            Is it living?
+ *           /             \
+ *       hat               Does it bark?
+ *                        /             \
+ *                   monkey             dog
+ */
+static void BuildTree(QATree &tree)
+{
+	tree.CreateQuestionAnswer("Is it living?", "monkey", "hat");
+	tree.CreateQuestionAnswer("Does it bark?", "dog", "monkey");
+}
+
+static void TestPlay()
+{
+	TestTree tree;
+	string question;
+	string answer;
+	int key;
+
+	CHECK(!tree.GetFirstQA(question));
+
+	BuildTree(tree);
+
+	CHECK(tree.Size() == 5);
+	CHECK(tree.GetFirstQA(question) && question == "Is it living?");
+	CHECK(!tree.IsAnswer(question));
+	CHECK(tree.GetNextQA(question, answer, INCORRECT_PATH) && answer == "hat");
+	CHECK(tree.IsAnswer(answer));
+	CHECK(tree.GetNextQA(question, answer, CORRECT_PATH) && answer == "Does it bark?");
+	CHECK(tree.GetNextQA(answer, answer, CORRECT_PATH) && answer == "dog");
+	CHECK(!tree.GetNextQA("dog", answer, CORRECT_PATH));
+	CHECK(!tree.IsAnswer("cat"));
+
+	CHECK(tree.Search("monkey", key) && tree.IsLeaf(key));
+	CHECK(tree.Search("Does it bark?", key) && !tree.IsLeaf(key));
+	CHECK(!tree.Search("cat", key));
+
+	/* A guess that is a question cannot be replaced */
+	CHECK(!tree.CreateQuestionAnswer("Does it fly?", "bird", "Is it living?"));
+	CHECK(!tree.CreateQuestionAnswer("Does it fly?", "bird", "cat"));
+	CHECK(tree.Size() == 5);
+}
+
+static void TestLearnMany()
+{
+	QATree tree;
+	vector<string> questions;
+	vector<int> qaPaths;
+	bool learned = true;
+
+	BuildTree(tree);
+
+	/* Each learn crowds the keys below "hat", which must not overflow them */
+	for (int i = 0; i < 100; i++)
+	{
+		ostringstream text;
+
+		text << i;
+		learned = tree.CreateQuestionAnswer("Is it thing " + text.str() + "?",
+		                                    "thing" + text.str(), "hat") && learned;
+	}
+
+	CHECK(learned && tree.Size() == 205);
+	CHECK(tree.IsAnswer("hat") && tree.IsAnswer("thing99"));
+	CHECK(tree.ExplainPath("hat", questions, qaPaths) && questions.size() == 101);
+}
+
+static void TestPlayByKey()
+{
+	TestTree tree;
+	string question;
+	string answer;
+	int key = 0;
+	int found = 0;
+
+	CHECK(!tree.GetFirstQA(question, key));
+
+	BuildTree(tree);
+
+	/* Walks by key reach the same questions and answers */
+	CHECK(tree.GetFirstQA(question, key) && question == "Is it living?");
+	CHECK(!tree.IsAnswer(question, key));
+	CHECK(tree.GetNextQA(question, key, answer, CORRECT_PATH) && answer == "Does it bark?");
+	CHECK(tree.Search(answer, found) && found == key);
+	CHECK(tree.GetNextQA(answer, key, answer, INCORRECT_PATH) && answer == "monkey");
+	CHECK(tree.IsAnswer(answer, key));
+	CHECK(!tree.GetNextQA(answer, key, question, CORRECT_PATH));
+
+	/* A key renumbered by learning falls back to the text */
+	CHECK(tree.GetFirstQA(question, key));
+	CHECK(tree.GetNextQA(question, key, answer, INCORRECT_PATH) && answer == "hat");
+	tree.CreateQuestionAnswer("Does it purr?", "cat", "monkey");
+	CHECK(tree.Search("hat", found) && found != key);
+	CHECK(tree.IsAnswer("hat", key));
+
+	tree.CreateQuestionAnswer("Is it red?", "cherry", "hat");
+	CHECK(tree.GetNextQA("Is it red?", key, answer, CORRECT_PATH) && answer == "cherry");
+	CHECK(tree.Search("cherry", found) && found == key);
+	CHECK(!tree.IsAnswer("Is it red?", key) && !tree.IsAnswer("parrot", key));
+}
+
+static void TestVisitCounting()
+{
+	TestTree tree;
+	string question;
+	string answer;
+	int key = 0;
+	int dogKey = 0;
+	long walks = 0;
+
+	BuildTree(tree);
+	tree.Search("Does it bark?", key);
+	tree.Search("dog", dogKey);
+
+	/* Visits are not counted until counting is enabled */
+	tree.GetFirstQA(question, key);
+	tree.GetNextQA(question, key, answer, CORRECT_PATH);
+	CHECK(tree.Visits(key) == 0);
+
+	tree.SetVisitCounting(true);
+	tree.GetFirstQA(question, key);
+	CHECK(tree.Visits(key) == 1);
+	tree.GetNextQA(question, key, answer, CORRECT_PATH);
+	CHECK(tree.Visits(key) == 1);
+	CHECK(tree.Navigate(key, answer, key, RIGHT_LINK) && key == dogKey);
+	CHECK(tree.Visits(dogKey) == 1);
+
+	/* Intervals other than powers of two are rejected */
+	CHECK(!tree.SetVisitCounting(true, 0) && !tree.SetVisitCounting(true, 12));
+
+	/* Sampled counts add the interval, so they estimate every visit */
+	CHECK(tree.SetVisitCounting(true, 16));
+	tree.Search("Does it bark?", key);
+
+	for (walks = 0; walks < 16000; walks++)
+		tree.Navigate(key, answer, dogKey, RIGHT_LINK);
+
+	CHECK(tree.Visits(dogKey) % 16 == 1);
+	CHECK(tree.Visits(dogKey) > 12000 && tree.Visits(dogKey) < 20000);
+
+	tree.SetVisitCounting(false);
+	tree.Navigate(key, answer, dogKey, RIGHT_LINK);
+	CHECK(tree.Visits(dogKey) % 16 == 1);
+}
+
+static void TestClassifyBatch()
+{
+	QATree tree;
+	vector<string> answerSets;
+	vector<string> answers;
+	const StringNode *leaves[6];
+	const StringNode *untouched = (const StringNode *) &answerSets;
+	int key = 0;
+
+	answerSets.push_back("yn");
+	answerSets.push_back("N");
+	answerSets.push_back("yy");
+	answerSets.push_back("y");
+	answerSets.push_back("x");
+	answerSets.push_back("nyyy");
+
+	/* An empty tree reaches no answers */
+	leaves[0] = untouched;
+	CHECK(tree.ClassifyBatch(answerSets, 0, 1, leaves) == 0 && leaves[0] == NULL);
+
+	BuildTree(tree);
+
+	/* Only the range is written, so threads may share the leaves */
+	for (int i = 0; i < 6; i++)
+		leaves[i] = untouched;
+
+	CHECK(tree.ClassifyBatch(answerSets, 1, 4, leaves) == 2);
+	CHECK(leaves[0] == untouched && leaves[4] == untouched && leaves[5] == untouched);
+	CHECK(leaves[1] != NULL && leaves[1]->info == "hat");
+	CHECK(leaves[2] != NULL && leaves[2]->info == "dog");
+	CHECK(leaves[3] == NULL);
+
+	/* Ranges past the end stop at the last answer set */
+	CHECK(tree.ClassifyBatch(answerSets, 0, 100, leaves) == 4);
+	CHECK(leaves[0] != NULL && leaves[0]->info == "monkey");
+	CHECK(leaves[4] == NULL);
+	CHECK(leaves[5] != NULL && leaves[5]->info == "hat");
+
+	/* Leaves are the tree's own nodes, identified by their keys too */
+	CHECK(tree.Search("dog", key) && leaves[2]->key == key);
+
+	CHECK(tree.ClassifyBatch(answerSets, answers) == 4);
+	CHECK(answers.size() == 6 && answers[0] == "monkey" && answers[3].empty());
+}
+
+static void TestSaveLoad()
+{
+	QATree tree;
+	QATree loaded;
+	stringstream saved;
+	ostringstream resaved;
+	string answer;
+
+	BuildTree(tree);
+	saved << tree;
+	loaded.LoadRecords(saved);
+	resaved << loaded;
+
+	CHECK(loaded.Size() == tree.Size());
+	CHECK(resaved.str() == saved.str());
+	CHECK(loaded.GetNextQA("Does it bark?", answer, INCORRECT_PATH) && answer == "monkey");
+}
+
+/*! Writes the records of a balanced tree of keys first to last - 1. */
+static void WriteBalanced(ostream &output, int first, int last)
+{
+	int middle = first + (last - first) / 2;
+
+	if (first >= last)
+		return;
+
+	output << middle << " Is it record " << middle << " of a tree spread over many blocks?\n";
+	WriteBalanced(output, first, middle);
+	WriteBalanced(output, middle + 1, last);
+}
+
+static void TestLoader()
+{
+	const char *fname = "qatreetest.tmp";
+	QATree streamed;
+	QATree pipelined;
+	QALoader loader;
+	ostringstream expected;
+	ostringstream loaded;
+
+	/* Several times the blocks in flight, ending without a new line */
+	{
+		ofstream ofile(fname, ios::binary);
+
+		WriteBalanced(ofile, 0, 100000);
+		ofile << "100000 last";
+	}
+
+	ifstream ifile(fname, ios::binary);
+
+	streamed.LoadRecords(ifile);
+	ifile.close();
+
+	CHECK(loader.Load(pipelined, fname));
+	CHECK(streamed.Size() == 100001 && pipelined.Size() == streamed.Size());
+
+	expected << streamed;
+	loaded << pipelined;
+	CHECK(loaded.str() == expected.str());
+	CHECK(pipelined.IsAnswer("last"));
+
+	/* The loader may be reused, and missing files are reported */
+	CHECK(loader.Load(pipelined, fname) && pipelined.Size() == 100001);
+	remove(fname);
+	CHECK(!loader.Load(pipelined, fname));
+}
+
+/*! Replaces a file with the given bytes. */
+static void WriteBytes(const char *fname, const string &bytes)
+{
+	ofstream ofile(fname, ios::binary);
+
+	ofile.write(bytes.data(), bytes.size());
+}
+
+static void TestImage()
+{
+	const char *fname = "qatreetest.tmp";
+	QATree tree;
+	QAImage image;
+	ostringstream written;
+	string bytes;
+	string damaged;
+	int node;
+
+	BuildTree(tree);
+	tree.WriteImage(written);
+	bytes = written.str();
+
+	/* The image walks like the tree it was written from */
+	WriteBytes(fname, bytes);
+	CHECK(image.Open(fname));
+	CHECK(image.NodeCount() == 5 && string(image.Text(0)) == "Is it living?");
+	CHECK(!image.IsAnswer(0));
+
+	node = image.NextQA(0, INCORRECT_PATH);
+	CHECK(image.IsAnswer(node) && string(image.Text(node)) == "hat");
+
+	node = image.NextQA(image.NextQA(0, CORRECT_PATH), CORRECT_PATH);
+	CHECK(image.IsAnswer(node) && string(image.Text(node)) == "dog");
+	CHECK(image.NextQA(node, CORRECT_PATH) == IMAGE_NO_LINK && image.Text(5) == NULL);
+
+	/* Truncated images are rejected, whether in the text, the nodes or the header */
+	WriteBytes(fname, bytes.substr(0, bytes.size() - 1));
+	CHECK(!image.Open(fname) && image.NodeCount() == 0);
+
+	WriteBytes(fname, bytes.substr(0, sizeof(QAImageHeader) + sizeof(QAImageNode)));
+	CHECK(!image.Open(fname));
+
+	WriteBytes(fname, bytes.substr(0, sizeof(QAImageHeader) - 1));
+	CHECK(!image.Open(fname));
+
+	WriteBytes(fname, "");
+	CHECK(!image.Open(fname));
+
+	/* So are images without the magic, or whose text is not terminated */
+	damaged = bytes;
+	damaged[0] = 'X';
+	WriteBytes(fname, damaged);
+	CHECK(!image.Open(fname));
+
+	damaged = bytes;
+	damaged[damaged.size() - 1] = 'x';
+	WriteBytes(fname, damaged);
+	CHECK(!image.Open(fname));
+
+	remove(fname);
+	CHECK(!image.Open(fname));
+}
+
+static void TestSnapshot()
+{
+	const char *fname = "qatreetest.tmp";
+	QATree tree;
+	QATree loaded;
+	QATree reloaded;
+	QASnapshot snapshot;
+	ostringstream expected;
+	ostringstream saved;
+
+	BuildTree(tree);
+	expected << tree;
+
+	/* Learning straight after Begin must not reach the saved file */
+	CHECK(snapshot.Begin(tree, fname));
+	tree.CreateQuestionAnswer("Does it purr?", "cat", "monkey");
+	CHECK(snapshot.Wait());
+
+	ifstream ifile(fname, ios::binary);
+
+	loaded.LoadRecords(ifile);
+	ifile.close();
+	saved << loaded;
+	CHECK(saved.str() == expected.str() && loaded.Size() == 5);
+
+	/* A second save sees the learn */
+	CHECK(snapshot.Begin(tree, fname) && snapshot.Wait());
+	ifile.open(fname, ios::binary);
+	reloaded.LoadRecords(ifile);
+	ifile.close();
+	CHECK(reloaded.IsAnswer("cat") && reloaded.Size() == 7);
+
+	/* A save that cannot be written is reported */
+	CHECK(snapshot.Begin(tree, "no such directory/qatreetest.tmp") && !snapshot.Wait());
+
+	remove(fname);
+}
+
+static void TestLearnBatch()
+{
+	QATree tree;
+	vector<QALearnRecord> records(3);
+	vector<int> conflicts;
+	string answer;
+
+	BuildTree(tree);
+
+	records[0].question = "Is it worn?";
+	records[0].answer = "glove";
+	records[0].alternateQA = "hat";
+	records[1].question = "Does it purr?";
+	records[1].answer = "cat";
+	records[1].alternateQA = "hat";
+	records[2].question = "Does it climb?";
+	records[2].answer = "monkey";
+	records[2].alternateQA = "parrot";
+
+	/* The second record names a guess already replaced, the third a missing one */
+	CHECK(tree.LearnBatch(records, conflicts) == 1);
+	CHECK(conflicts.size() == 2 && conflicts[0] == 1 && conflicts[1] == 2);
+	CHECK(tree.GetNextQA("Is it worn?", answer, CORRECT_PATH) && answer == "glove");
+	CHECK(tree.GetNextQA("Is it worn?", answer, INCORRECT_PATH) && answer == "hat");
+	CHECK(tree.Size() == 7);
+}
+
+static void TestExplainPath()
+{
+	QATree tree;
+	vector<string> questions;
+	vector<int> qaPaths;
+
+	CHECK(!tree.ExplainPath("hat", questions, qaPaths));
+
+	BuildTree(tree);
+
+	CHECK(tree.ExplainPath("monkey", questions, qaPaths));
+	CHECK(questions.size() == 2 && qaPaths.size() == 2);
+	CHECK(questions[0] == "Is it living?" && qaPaths[0] == CORRECT_PATH);
+	CHECK(questions[1] == "Does it bark?" && qaPaths[1] == INCORRECT_PATH);
+
+	CHECK(tree.ExplainPath("hat", questions, qaPaths));
+	CHECK(questions.size() == 1 && questions[0] == "Is it living?");
+	CHECK(qaPaths.size() == 1 && qaPaths[0] == INCORRECT_PATH);
+
+	/* Questions and missing texts have no path */
+	CHECK(!tree.ExplainPath("Does it bark?", questions, qaPaths));
+	CHECK(questions.empty() && qaPaths.empty());
+	CHECK(!tree.ExplainPath("cat", questions, qaPaths));
+
+	/* Paths follow keys, so they must survive learning and reclustering */
+	tree.CreateQuestionAnswer("Does it purr?", "cat", "monkey");
+	tree.Recluster(0);
+
+	CHECK(tree.ExplainPath("cat", questions, qaPaths));
+	CHECK(questions.size() == 3 && questions[2] == "Does it purr?");
+	CHECK(qaPaths.size() == 3 && qaPaths[1] == INCORRECT_PATH && qaPaths[2] == CORRECT_PATH);
+}
+
+static void TestMerge()
+{
+	QATree base;
+	QATree first;
+	QATree second;
+	QATree merged;
+	QATree empty;
+	vector<string> conflicts;
+	string answer;
+
+	BuildTree(base);
+
+	/* Both learn the same question below "hat", and the second learns below it too */
+	first = base;
+	first.CreateQuestionAnswer("Is it worn?", "glove", "hat");
+	second = first;
+	second.CreateQuestionAnswer("Is it red?", "cap", "hat");
+	second.CreateQuestionAnswer("Does it meow?", "cat", "monkey");
+
+	CHECK(merged.Merge(base, first, second, conflicts));
+	CHECK(conflicts.empty());
+	CHECK(merged.Size() == 11);
+	CHECK(merged.GetNextQA("Is it worn?", answer, INCORRECT_PATH) && answer == "Is it red?");
+	CHECK(merged.GetNextQA("Is it red?", answer, CORRECT_PATH) && answer == "cap");
+	CHECK(merged.GetNextQA("Does it meow?", answer, CORRECT_PATH) && answer == "cat");
+
+	/* Different questions learned below the same answer conflict */
+	second = base;
+	second.CreateQuestionAnswer("Is it round?", "ball", "hat");
+
+	CHECK(!merged.Merge(base, first, second, conflicts));
+	CHECK(conflicts.size() == 1 && conflicts[0] == "Is it worn?");
+	CHECK(merged.IsAnswer("glove") && !merged.IsAnswer("ball"));
+
+	/* Trees grown from an empty base merge as far as they agree */
+	CHECK(merged.Merge(empty, base, first, conflicts));
+	CHECK(merged.Size() == 7 && merged.IsAnswer("glove"));
+
+	second = empty;
+	second.CreateQuestionAnswer("Is it blue?", "sky", "grass");
+
+	CHECK(!merged.Merge(empty, base, second, conflicts));
+	CHECK(conflicts.size() == 1 && conflicts[0] == "Is it living?");
+
+	/* Identical trees merge into a copy */
+	CHECK(merged.Merge(empty, first, first, conflicts));
+	CHECK(merged.Size() == first.Size() && merged.IsAnswer("glove"));
+	CHECK(merged.GetNextQA("Is it worn?", answer, INCORRECT_PATH) && answer == "hat");
+}
+
+static void TestReserve()
+{
+	NodePool<string> pool;
+	StringNode *nodes[4];
+	StringNode *reserved[3];
+
+	for (int i = 0; i < 4; i++)
+		nodes[i] = pool.Allocate();
+
+	pool.Release(nodes[1]);
+	pool.Release(nodes[2]);
+
+	/* Reserved nodes come from one block, not from the free list */
+	pool.Reserve(3);
+
+	for (int i = 0; i < 3; i++)
+		reserved[i] = pool.Allocate();
+
+	CHECK(reserved[1] == reserved[0] + 1 && reserved[2] == reserved[1] + 1);
+	CHECK(reserved[0] != nodes[1] && reserved[0] != nodes[2]);
+	CHECK(pool.InUse() == 5);
+
+	/* Once they are used up, the free list is reused */
+	CHECK(pool.Allocate() == nodes[2]);
+}
+
+static void TestForest()
+{
+	const char *fname = "qatreetest.tmp";
+	QATreeForest forest;
+	QATree tree;
+	ofstream ofile(fname);
+	ostringstream saved;
+	ostringstream restored;
+	vector<string> questions;
+	vector<int> qaPaths;
+	size_t bytes;
+	size_t parked;
+
+	BuildTree(tree);
+	ofile << tree;
+	ofile.close();
+	saved << tree;
+
+	CHECK(forest.Load("a", fname) && forest.Load("b", fname) && forest.Load("c", fname));
+	CHECK(!forest.Load("d", "missing.tmp"));
+	CHECK(forest.TreeCount() == 3 && forest.NodesInUse() == 15);
+
+	/* Each tree has its own pool, so unloading one frees its memory */
+	bytes = forest.NodeBytes();
+	CHECK(forest.Unload("c"));
+	CHECK(forest.NodeBytes() < bytes && forest.NodesInUse() == 10);
+	CHECK(forest.Find("c") == NULL && !forest.Unload("c"));
+
+	/* Parked trees share their text, so a second costs only its records */
+	bytes = forest.NodeBytes();
+	CHECK(forest.Park("a"));
+	parked = forest.ParkedBytes();
+	CHECK(forest.Park("b"));
+	CHECK(forest.ParkedBytes() == parked + 5 * sizeof(QAParkedRecord));
+	CHECK(forest.ParkedCount() == 2 && forest.NodesInUse() == 0);
+	CHECK(forest.NodeBytes() < bytes);
+	CHECK(!forest.Park("c"));
+
+	/* A parked tree is rebuilt as it was */
+	CHECK(forest.Find("a") != NULL);
+	CHECK(forest.ParkedCount() == 1 && forest.ParkedBytes() == parked);
+	restored << *forest.Find("a");
+	CHECK(restored.str() == saved.str());
+	CHECK(forest.Find("a")->ExplainPath("dog", questions, qaPaths) && questions.size() == 2);
+
+	CHECK(forest.Unload("b"));
+	CHECK(forest.ParkedCount() == 0 && forest.ParkedBytes() == 0);
+
+	remove(fname);
+}
+
+static void TestQueriesDoNotAllocate(long rounds)
+{
+	TestTree tree;
+	string question;
+	string answer;
+	string found;
+	int key = 0;
+	int keyFound = 0;
+	int walkKey = 0;
+	long before;
+	bool ok = true;
+
+	BuildTree(tree);
+
+	/* Caller strings are given their capacity before counting starts */
+	question.reserve(64);
+	answer.reserve(64);
+	found.reserve(64);
+
+	before = allocations;
+
+	for (long i = 0; i < rounds; i++)
+	{
+		ok = tree.GetFirstQA(question) && ok;
+		ok = !tree.IsAnswer(question) && ok;
+		ok = tree.GetNextQA(question, answer, CORRECT_PATH) && ok;
+		ok = tree.GetNextQA(question, answer, INCORRECT_PATH) && ok;
+		ok = tree.IsAnswer(answer) && ok;
+		ok = tree.Search(answer, key) && ok;
+		ok = tree.IsLeaf(key) && ok;
+		ok = tree.Search(question, key) && ok;
+		ok = tree.Navigate(key, found, keyFound, RIGHT_LINK) && ok;
+		ok = tree.GetFirstQA(question, walkKey) && ok;
+		ok = tree.GetNextQA(question, walkKey, answer, INCORRECT_PATH) && ok;
+		ok = tree.IsAnswer(answer, walkKey) && ok;
+	}
+
+	CHECK(ok);
+	CHECK(allocations == before);
+
+	if (allocations != before)
+		cout << "  " << allocations - before << " allocations in " << rounds << " rounds" << endl;
+}
+
+int main(int argc, char** argv) {
+
+	long rounds = (argc > 1) ? atol(argv[1]) : 1000000;
+
+	TestPlay();
+	TestLearnMany();
+	TestPlayByKey();
+	TestVisitCounting();
+	TestClassifyBatch();
+	TestSaveLoad();
+	TestLoader();
+	TestImage();
+	TestSnapshot();
+	TestLearnBatch();
+	TestExplainPath();
+	TestMerge();
+	TestReserve();
+	TestForest();
+	TestQueriesDoNotAllocate(rounds);
+
+	if (failures != 0)
+	{
+		cout << failures << " checks failed." << endl;
+		return (EXIT_FAILURE);
+	}
+
+	cout << "All checks passed." << endl;
+	return (EXIT_SUCCESS);
+}
@@ -4,19 +4,36 @@
  *  Defines a binary tree data structure.
  *
  *  \author Blair Jordan
- *  \version 1.0
- *  \date 20-MAY-2009
+ *  \version 12.0
+ *  \date 19-OCT-2026
  *
  * <pre>
  *  Revision  Name        Date         Description
  *  1         B. Jordan   20-MAY-2009  Created
+ *  2         agent       19-OCT-2026  Nodes allocated from a NodePool
+ *  3         agent       19-OCT-2026  Added Recluster function
+ *  4         agent       19-OCT-2026  Trees may share a node pool
+ *  5         agent       19-OCT-2026  Added Size and Height functions
+ *  6         agent       19-OCT-2026  CopyTree copies node keys
+ *  7         agent       19-OCT-2026  Added parent links to NodeType
+ *  8         agent       19-OCT-2026  Search takes a const search item
+ *  9         agent       19-OCT-2026  Added node visit counts. Recluster
+ *                                     places the most visited child first.
+ *  10        agent       19-OCT-2026  Recluster and operator= reserve a
+ *                                     block for the whole tree
+ *  11        agent       19-OCT-2026  Visit counts are unsigned. Recluster
+ *                                     places every hot node first.
+ *  12        agent       19-OCT-2026  Removed parent links from NodeType
  * </pre>
 */
 
 #ifndef _BINARYTREE_H
 #define	_BINARYTREE_H
 
+#include "nodepool.h"
 #include <iostream>
+#include <algorithm>
+#include <vector>
 
 using namespace std;
 
@@ -30,6 +47,7 @@ template <class elemType>
 struct NodeType
 {
     int key;                                // A unique key for the node
+    unsigned int visits;                    // The number of times the node was reached
 	elemType info;                          // The data stored by the node
 	NodeType<elemType> *lLink;		        // A pointer to the left child node
 	NodeType<elemType> *rLink;              // A pointer to the right child node
@@ -42,6 +60,11 @@ public:
     /*! Default constructor for a binary tree. */
 	BinaryTreeType();
 
+	/*! Constructor for a binary tree that allocates from a shared pool.
+	 *  \param pool The pool to allocate nodes from. It must outlive the tree.
+	 */
+	BinaryTreeType(NodePool<elemType> *pool);
+
 	/*! Destructor for a binary tree. */
 	virtual ~BinaryTreeType();
 	
@@ -57,7 +80,7 @@ public:
 	 *  \retval true If the search item is found.
 	 *  \retval false If the search item is not found .
 	 */
-	virtual bool Search(elemType &searchItem, int &key) const = 0;
+	virtual bool Search(const elemType &searchItem, int &key) const = 0;
 
 	/*! Returns true if an item is a leaf node, otherwise false is returned.
 	 *  \retval true If an item is found and has no children.
@@ -71,6 +94,15 @@ public:
 	 */
 	bool IsEmpty();
 
+	/*! Returns the number of nodes in the tree. */
+	int Size() const;
+
+	/*! Returns the height of the tree, counted in nodes (0 if empty). The
+	 *  height is not stored, since rebuilding a subtree may lower it, so each
+	 *  call walks every node and costs O(size).
+	 */
+	int Height() const;
+
         /*! Performs inorder traversal of tree, printing each node. */
 	void InorderTraverse();
 
@@ -80,6 +112,19 @@ public:
 	/*! Performs postorder traversal of tree, printing each node. */
 	void PostorderTraverse();
 
+	/*! Moves every node into a fresh block in preorder, so that each subtree
+	 *  occupies a contiguous run of memory. Trees that have learned since they
+	 *  were loaded can be reclustered to keep root-to-leaf walks on as few
+	 *  pages as possible. This only helps walks that follow links or keys; a
+	 *  search by text still visits every node. Where visits have been counted, every node visited
+	 *  at least hotVisits times is placed first, packing all of the hot paths
+	 *  together at the start of the block, and the more visited child of each
+	 *  node comes first. The cold subtrees follow, each in preorder.
+	 *  \param hotVisits The visits that make a node hot. With 0, every node
+	 *                   is hot.
+	 */
+	void Recluster(unsigned int hotVisits = 1);
+
 	/* Copies tree contents to another tree */
 	void CopyTree(NodeType<elemType>* &destRoot,
 				  NodeType<elemType>* sourceRoot);
@@ -111,9 +156,36 @@ protected:
 	 * \param node A pointer to the parent node.
 	 */
 	void Destroy(NodeType<elemType> *node);
+
+	/*! Counts the nodes of a subtree.
+	 * \param node The root node of the subtree.
+	 */
+	int CountNodes(NodeType<elemType> *node) const;
+
+	/*! Returns the height of a subtree, counted in nodes.
+	 * \param node The root node of the subtree.
+	 */
+	int NodeHeight(NodeType<elemType> *node) const;
+
+	/*! Lists every node in the order Recluster lays them out: hot nodes in
+	 * preorder, then each cold subtree in preorder. An explicit stack is used,
+	 * so the depth of the tree does not matter.
+	 * \param order The nodes in layout order.
+	 * \param hotVisits The visits that make a node hot.
+	 */
+	void LayoutOrder(vector< NodeType<elemType>* > &order, unsigned int hotVisits) const;
         
 	/*! A pointer to the root node of the binary search tree. */
 	NodeType<elemType> *root;
+
+	/*! The pool that every node of the tree is allocated from. */
+	NodePool<elemType> *nodePool;
+
+	/*! True if the tree created its own pool, and so must delete it. */
+	bool ownsPool;
+
+	/*! The number of nodes in the tree. */
+	int nodeCount;
 };
 
 template <class elemType>
@@ -174,6 +246,36 @@ bool BinaryTreeType<elemType>::IsEmpty()
     return (this->root == NULL) ? true : false;
 }
 
+template <class elemType>
+int BinaryTreeType<elemType>::Size() const
+{
+    return nodeCount;
+}
+
+template <class elemType>
+int BinaryTreeType<elemType>::Height() const
+{
+    return NodeHeight(root);
+}
+
+template <class elemType>
+int BinaryTreeType<elemType>::CountNodes(NodeType<elemType> *node) const
+{
+    if (node == NULL)
+        return 0;
+
+    return 1 + CountNodes(node->lLink) + CountNodes(node->rLink);
+}
+
+template <class elemType>
+int BinaryTreeType<elemType>::NodeHeight(NodeType<elemType> *node) const
+{
+    if (node == NULL)
+        return 0;
+
+    return 1 + max(NodeHeight(node->lLink), NodeHeight(node->rLink));
+}
+
 template <class elemType>
 void BinaryTreeType<elemType>::Destroy(NodeType<elemType> *node)
 {
@@ -181,11 +283,115 @@ void BinaryTreeType<elemType>::Destroy(NodeType<elemType> *node)
 	{
 		Destroy(node->lLink);
 		Destroy(node->rLink);
-		delete node;
+		nodePool->Release(node);
 		node = NULL;
 	}
 }
 
+template <class elemType>
+void BinaryTreeType<elemType>::Recluster(unsigned int hotVisits)
+{
+	NodePool<elemType> clustered;
+	NodePool<elemType> *pool = ownsPool ? &clustered : nodePool;
+	vector< NodeType<elemType>* > order;
+	vector< NodeType<elemType>* > moved;
+	vector< NodeType<elemType>* > right;
+	NodeType<elemType> *left;
+	size_t i;
+
+	if (root == NULL)
+		return;
+
+	LayoutOrder(order, hotVisits);
+	pool->Reserve(order.size());
+	moved.resize(order.size());
+	right.resize(order.size());
+
+	for (i = 0; i < order.size(); i++)
+	{
+		moved[i] = pool->Allocate();
+		moved[i]->key = order[i]->key;
+		moved[i]->visits = order[i]->visits;
+		swap(moved[i]->info, order[i]->info);
+	}
+
+	/* Each old node's left link forwards to its moved copy until relinked,
+	   so its own left child is kept in the moved copy meanwhile */
+	for (i = 0; i < order.size(); i++)
+	{
+		moved[i]->lLink = order[i]->lLink;
+		right[i] = order[i]->rLink;
+		order[i]->lLink = moved[i];
+	}
+
+	for (i = 0; i < order.size(); i++)
+	{
+		left = moved[i]->lLink;
+		moved[i]->lLink = (left != NULL) ? left->lLink : NULL;
+		moved[i]->rLink = (right[i] != NULL) ? right[i]->lLink : NULL;
+	}
+
+	root = root->lLink;
+
+	if (ownsPool)
+	{
+		/* The old blocks are freed when clustered goes out of scope */
+		nodePool->Swap(clustered);
+	}
+	else
+	{
+		/* A shared pool cannot be replaced, so the old nodes are released */
+		for (i = 0; i < order.size(); i++)
+			nodePool->Release(order[i]);
+	}
+}
+
+template <class elemType>
+void BinaryTreeType<elemType>::LayoutOrder(vector< NodeType<elemType>* > &order,
+										   unsigned int hotVisits) const
+{
+	vector< NodeType<elemType>* > pending;
+	vector< NodeType<elemType>* > cold;
+	NodeType<elemType> *node;
+	NodeType<elemType> *first;
+	NodeType<elemType> *second;
+	size_t c;
+
+	order.reserve(nodeCount);
+	pending.push_back(root);
+
+	/* Hot nodes are taken first, then each cold subtree in the order reached */
+	for (c = 0; !pending.empty() || c < cold.size(); )
+	{
+		if (pending.empty())
+			pending.push_back(cold[c++]);
+
+		node = pending.back();
+		pending.pop_back();
+
+		if (c == 0 && node->visits < hotVisits)
+		{
+			cold.push_back(node);
+			continue;
+		}
+
+		order.push_back(node);
+
+		/* The more visited child is pushed last, so it is taken first */
+		first = node->lLink;
+		second = node->rLink;
+
+		if (first != NULL && second != NULL && second->visits > first->visits)
+			swap(first, second);
+
+		if (second != NULL)
+			pending.push_back(second);
+
+		if (first != NULL)
+			pending.push_back(first);
+	}
+}
+
 template <class elemType>
 void BinaryTreeType<elemType>::CopyTree(NodeType<elemType>* &destRoot,
 										NodeType<elemType>* sourceRoot)
@@ -194,7 +400,9 @@ void BinaryTreeType<elemType>::CopyTree(NodeType<elemType>* &destRoot,
 		destRoot = NULL;
 	else
 	{
-		destRoot = new NodeType<elemType>;
+		destRoot = nodePool->Allocate();
+		destRoot->key = sourceRoot->key;
+		destRoot->visits = sourceRoot->visits;
 		destRoot->info = sourceRoot->info;
 		CopyTree(destRoot->lLink, sourceRoot->lLink);
 		CopyTree(destRoot->rLink, sourceRoot->rLink);
@@ -206,6 +414,18 @@ template <class elemType>
 BinaryTreeType<elemType>::BinaryTreeType()
 {
 	root = NULL;
+	nodePool = new NodePool<elemType>;
+	ownsPool = true;
+	nodeCount = 0;
+}
+
+template <class elemType>
+BinaryTreeType<elemType>::BinaryTreeType(NodePool<elemType> *pool)
+{
+	root = NULL;
+	nodePool = pool;
+	ownsPool = false;
+	nodeCount = 0;
 }
 
 
@@ -213,6 +433,9 @@ template <class elemType>
 BinaryTreeType<elemType>::~BinaryTreeType()
 {
 	Destroy(root);
+
+	if (ownsPool)
+		delete nodePool;
 }
 
 template <class elemType>
@@ -227,7 +450,12 @@ const BinaryTreeType<elemType>& BinaryTreeType<elemType>::
 		if (tree.root == NULL)
 			root = NULL;
 		else
+		{
+			nodePool->Reserve(tree.nodeCount);
 			CopyTree(root, tree.root);
+		}
+
+		nodeCount = tree.nodeCount;
 	}
 
 	return *this;
@@ -4,8 +4,8 @@
  *  Defines a binary search tree data structure.
  *
  *  \author Blair Jordan
- *  \version 5.0
- *  \date 16-MAY-2009
+ *  \version 16.0
+ *  \date 19-OCT-2026
  *
  * <pre>
  *  Revision  Name        Date         Description
@@ -18,6 +18,20 @@
  *  5         B. Jordan   20-MAY-2009  Incorporated scaling functionality from qatree
  *  6         B. Jordan   20-MAY-2009  Fixed return flags CreateQuestionAnswer and
  *                                     GetNextQA errors identified in test plan.
+ *  7         agent       19-OCT-2026  Insert allocates nodes from the node pool.
+ *  8         agent       19-OCT-2026  Added shared pool constructor.
+ *  9         agent       19-OCT-2026  Added optional scapegoat rebalancing.
+ *  10        agent       19-OCT-2026  Parent links kept by Insert and rebuilds.
+ *                                     Added FindNode function.
+ *  11        agent       19-OCT-2026  Search and IsLeaf no longer allocate.
+ *  12        agent       19-OCT-2026  SetRebalance rejects balance factors
+ *                                     outside (0.5, 1).
+ *  13        agent       19-OCT-2026  Added assignment operator.
+ *  14        agent       19-OCT-2026  Defines DEFAULT_SCALE, which ScaleNodes
+ *                                     uses.
+ *  15        agent       19-OCT-2026  Parent links removed.
+ *  16        agent       19-OCT-2026  Added sampled visit counting, moved from
+ *                                     QATree. Navigate counts visits.
  * </pre>
 */
 
@@ -26,9 +40,16 @@
 
 #include "binarytree.h"
 #include <iostream>
+#include <vector>
+#include <cmath>
+#include <climits>
 
 using namespace std;
 
+const int DEFAULT_SCALE = 1;            // Defines the default node scale
+const double DEFAULT_BALANCE = 0.7;     // The default scapegoat balance factor
+const unsigned int VISIT_SEED = 2463534242u;  // Seeds the visit sampler; never 0
+
 template <class elemType>
 class BSTType : public BinaryTreeType<elemType>
 {
@@ -37,6 +58,11 @@ public:
 	/*! Default constructor for a binary search tree. */
 	BSTType();
 
+	/*! Constructor for a binary search tree that allocates from a shared pool.
+	 *  \param pool The pool to allocate nodes from. It must outlive the tree.
+	 */
+	BSTType(NodePool<elemType> *pool);
+
 	/*! Destructor for a binary search tree. */
 	virtual ~BSTType();
 
@@ -45,6 +71,13 @@ public:
 	 */
 	BSTType(const BSTType& tree);
 
+	/*! Overloaded assignment operator. Copies the nodes and the scaling and
+	 *  rebalancing settings.
+	 *  \param  tree A reference to the assigning binary search tree.
+	 *  \retval tree A reference to the assigned binary search tree.
+	 */
+	const BSTType& operator= (const BSTType<elemType>& tree);
+
 	/*! Inserts a new item into the tree.
 	 *  \param newItem The new data to be inserted into the tree.
 	 *  \param key A unique identifier for the item .
@@ -57,7 +90,7 @@ public:
 	 *  \retval true If the search item is found.
 	 *  \retval false If the search item is not found .
 	 */
-	bool Search(elemType &searchItem, int &key) const;
+	bool Search(const elemType &searchItem, int &key) const;
 
 	/*! Searches for a node via key and, if found, replaces info.
 	 *  \param key The uniquely identifying key for the search element.
@@ -67,10 +100,70 @@ public:
 	 */
 	bool ReplaceInfo(int key, elemType &newElement);
 
+	/*! Enables or disables rebalancing on insert. When enabled, an insert that
+	 *  lands deeper than log(size) / log(1 / balance) finds the lowest ancestor
+	 *  whose child subtree holds more than balance times its own size, and
+	 *  rebuilds that ancestor's subtree into perfect balance. Keys are kept, so
+	 *  key navigation is unaffected, but the shape of the tree changes.
+	 *  Rebalancing is disabled by default, and must stay disabled for trees
+	 *  whose shape is meaningful, such as a QATree.
+	 *  \param enabled True to rebalance on insert.
+	 *  \param balance The balance factor, greater than 0.5 and less than 1.
+	 *  \retval true If the settings were changed.
+	 *  \retval false If the balance factor is out of range. The settings are
+	 *                 left unchanged.
+	 */
+	bool SetRebalance(bool enabled, double balance = DEFAULT_BALANCE);
+
+	/*! Rebuilds the whole tree into perfect balance. */
+	void Rebalance();
+
+	/*! Enables or disables visit counting. While enabled, each node reached
+	 *  by following a link (by Navigate, or by QATree's GetFirstQA and
+	 *  GetNextQA) may be counted, and Recluster uses the counts to pack the
+	 *  most visited paths together. With an interval above 1, a visit is
+	 *  counted with a chance of one in interval, drawn from a xorshift
+	 *  generator, and adds interval to the count, so the cost of a visit
+	 *  is a few register operations and a write to one node in interval.
+	 *  Counts stop at UINT_MAX rather than wrapping. Disabled by default.
+	 *  Counts are plain integers rather than atomics, since the tree builds
+	 *  as C++98 and is never walked from more than one thread without the
+	 *  lock that learning needs (see QALearnQueue), so a tree shared between
+	 *  threads must be walked under that lock while visits are counted.
+	 *  \param enabled True to count visits.
+	 *  \param interval The sampling interval, a power of two. 1 counts every
+	 *                  visit.
+	 *  \retval true If the settings were changed.
+	 *  \retval false If the interval is not a power of two. The settings are
+	 *                 left unchanged.
+	 */
+	bool SetVisitCounting(bool enabled, unsigned int interval = 1);
+
 protected:
+
+	/*! True if inserts rebalance the tree. */
+	bool autoRebalance;
+
+	/*! The scapegoat balance factor used when rebalancing. */
+	double balanceFactor;
     
 	/*! Stores the current scale of tree nodes */
     int nodeScale;
+
+	/*! True if visits are counted. */
+	bool countVisits;
+
+	/*! One visit in this many is counted. */
+	unsigned int visitInterval;
+
+	/*! The state of the generator that samples visits. */
+	mutable unsigned int visitSeed;
+
+	/*! Counts a visit to a node, if visits are counted and the visit is
+	 *  sampled.
+	 *  \param node The node visited.
+	 */
+	void CountVisit(NodeType<elemType> *node) const;
 	
 	/*! Returns true if tree nodes require scaling before adding additional
 	 *  items.
@@ -103,29 +196,62 @@ protected:
 	 */
 	bool Navigate(int key, elemType &elemFound, int &keyFound, int direction) const;
 	
-	/*! Recursively searches for a node and returns the item, if found
+	/*! Recursively searches for a node depth-first, in the same order as Search
 	 * \param currentNode The parent node to search from
 	 * \param searchItem The item being searched
-	 * \retval true If the node is found
-	 * \retval false If the node is not found
+	 * \retval node The first node holding the item, or NULL if not found
+	 */
+	NodeType<elemType>* FindNode(NodeType<elemType>* currentNode,
+	                             const elemType &searchItem) const;
+
+	/*! Searches for a node via key
+	 * \param key The uniquely identifying key of the node
+	 * \retval node The node holding the key, or NULL if not found
 	 */
-	bool SearchNode(NodeType<elemType>* currentNode, NodeType<elemType>* &searchItem) const;
+	NodeType<elemType>* FindKey(int key) const;
 	
 	/*! Inserts a new node into the binary search tree
 	 * \param newNode The node item to insert into the 
 	 * \param parentNode The parent node of the current new node
 	 */
-	void Insert(NodeType<elemType>* &newNode, NodeType<elemType>* &parentNode);
+	bool Insert(NodeType<elemType>* &newNode, NodeType<elemType>* &parentNode);
+
+	/*! Inserts a new node, recording its path, and rebuilds the subtree of the
+	 *  scapegoat ancestor if the new node is too deep.
+	 * \param newNode The node item to insert into the tree
+	 * \retval true If the node was inserted
+	 * \retval false If the key is a duplicate
+	 */
+	bool InsertBalanced(NodeType<elemType>* newNode);
+
+	/*! Rebuilds a subtree into perfect balance.
+	 * \param node The root node of the subtree.
+	 * \retval root The root node of the rebuilt subtree.
+	 */
+	NodeType<elemType>* RebuildSubtree(NodeType<elemType>* node);
+
+	/*! Appends the nodes of a subtree to a list in key order.
+	 * \param node The root node of the subtree.
+	 * \param nodes The list of nodes.
+	 */
+	void Flatten(NodeType<elemType>* node, vector< NodeType<elemType>* > &nodes);
+
+	/*! Links a run of nodes in key order into a perfectly balanced subtree.
+	 * \param nodes The list of nodes.
+	 * \param first The index of the first node in the run.
+	 * \param last The index one past the last node in the run.
+	 * \retval root The root node of the subtree.
+	 */
+	NodeType<elemType>* BuildBalanced(vector< NodeType<elemType>* > &nodes,
+	                                  int first, int last);
 };
 
 template <class elemType>
 bool BSTType<elemType>::IsLeaf(const int key)
 {
-    elemType elemInfo;
-    int keyFound;
+    NodeType<elemType> *node = FindKey(key);
 
-    if ( !Navigate(key, elemInfo, keyFound, LEFT_LINK)
-     && (!Navigate(key, elemInfo, keyFound, RIGHT_LINK)))
+    if (node != NULL && node->lLink == NULL && node->rLink == NULL)
         return true;
     else
         return false;
@@ -135,7 +261,7 @@ template <class elemType>
 void BSTType<elemType>::Insert(const elemType newItem, int key)
 {
 	NodeType<elemType> *newNode;
-	newNode = new NodeType<elemType>;
+	newNode = this->nodePool->Allocate();
 
 	newNode->info = newItem;
     newNode->key = key;
@@ -146,16 +272,23 @@ void BSTType<elemType>::Insert(const elemType newItem, int key)
 	if (this->root == NULL)
 	{
 		this->root = newNode;
+		this->nodeCount++;
+	}
+	else if (autoRebalance ? InsertBalanced(newNode) : Insert(newNode, this->root))
+	{
+		this->nodeCount++;
 	}
 	else
 	{
-		Insert(newNode, this->root);
+		this->nodePool->Release(newNode);
 	}
 }
 
 template <class elemType>
-void BSTType<elemType>::Insert(NodeType<elemType>* &newNode, NodeType<elemType>* &parentNode)
+bool BSTType<elemType>::Insert(NodeType<elemType>* &newNode, NodeType<elemType>* &parentNode)
 {
+	bool inserted = false;
+
 	if (parentNode == NULL)
 		cout << "Error: Unable to insert node. Parent not found." << endl;
         else
@@ -164,35 +297,167 @@ void BSTType<elemType>::Insert(NodeType<elemType>* &newNode, NodeType<elemType>*
 		if (newNode->key < parentNode->key)
 		{
 			if (parentNode->lLink == NULL)
+			{
 				parentNode->lLink = newNode;
+				inserted = true;
+			}
 			else
-				Insert(newNode, parentNode->lLink);
+				inserted = Insert(newNode, parentNode->lLink);
 		}
 		else if (newNode->key > parentNode->key)
 		{
 			if (parentNode->rLink == NULL)
+			{
 				parentNode->rLink = newNode;
+				inserted = true;
+			}
 			else
-				Insert(newNode, parentNode->rLink);
+				inserted = Insert(newNode, parentNode->rLink);
 		}
 		else
 		{
 			cout << "Error: Unable to insert duplicate node." << endl;
 		}
 	}
+
+	return inserted;
+}
+
+template <class elemType>
+bool BSTType<elemType>::InsertBalanced(NodeType<elemType>* newNode)
+{
+	vector< NodeType<elemType>* > path;
+	NodeType<elemType> *current = this->root;
+	NodeType<elemType> *child;
+	int childSize;
+	int size;
+	int i;
+
+	while (current != NULL)
+	{
+		path.push_back(current);
+
+		if (newNode->key < current->key)
+			current = current->lLink;
+		else if (newNode->key > current->key)
+			current = current->rLink;
+		else
+		{
+			cout << "Error: Unable to insert duplicate node." << endl;
+			return false;
+		}
+	}
+
+	if (newNode->key < path.back()->key)
+		path.back()->lLink = newNode;
+	else
+		path.back()->rLink = newNode;
+
+	/* Only a node deeper than the balanced height bound needs a scapegoat */
+	if (path.size() > log((double) this->nodeCount + 1) / log(1.0 / balanceFactor))
+	{
+		child = newNode;
+		childSize = 1;
+
+		for (i = (int) path.size() - 1; i >= 0; i--)
+		{
+			size = 1 + childSize + this->CountNodes((path[i]->lLink == child)
+			                                        ? path[i]->rLink : path[i]->lLink);
+
+			if (childSize > balanceFactor * size)
+			{
+				current = RebuildSubtree(path[i]);
+
+				if (i == 0)
+					this->root = current;
+				else if (path[i - 1]->lLink == path[i])
+					path[i - 1]->lLink = current;
+				else
+					path[i - 1]->rLink = current;
+
+				break;
+			}
+
+			child = path[i];
+			childSize = size;
+		}
+	}
+
+	return true;
+}
+
+template <class elemType>
+bool BSTType<elemType>::SetRebalance(bool enabled, double balance)
+{
+	/* At 0.5 no tree is balanced enough; at 1 no insert ever finds a scapegoat */
+	if (!(balance > 0.5 && balance < 1.0))
+	{
+		cout << "Error: Balance factor must be between 0.5 and 1." << endl;
+		return false;
+	}
+
+	autoRebalance = enabled;
+	balanceFactor = balance;
+
+	return true;
+}
+
+template <class elemType>
+void BSTType<elemType>::Rebalance()
+{
+	this->root = RebuildSubtree(this->root);
+}
+
+template <class elemType>
+NodeType<elemType>* BSTType<elemType>::RebuildSubtree(NodeType<elemType>* node)
+{
+	vector< NodeType<elemType>* > nodes;
+
+	Flatten(node, nodes);
+
+	return BuildBalanced(nodes, 0, (int) nodes.size());
+}
+
+template <class elemType>
+void BSTType<elemType>::Flatten(NodeType<elemType>* node,
+                                vector< NodeType<elemType>* > &nodes)
+{
+	if (node != NULL)
+	{
+		Flatten(node->lLink, nodes);
+		nodes.push_back(node);
+		Flatten(node->rLink, nodes);
+	}
 }
 
 template <class elemType>
-bool BSTType<elemType>::Search(elemType &searchItem, int &key) const
+NodeType<elemType>* BSTType<elemType>::BuildBalanced(vector< NodeType<elemType>* > &nodes,
+                                                     int first, int last)
+{
+	NodeType<elemType> *node = NULL;
+	int middle;
+
+	if (first < last)
+	{
+		middle = first + (last - first) / 2;
+		node = nodes[middle];
+		node->lLink = BuildBalanced(nodes, first, middle);
+		node->rLink = BuildBalanced(nodes, middle + 1, last);
+	}
+
+	return node;
+}
+
+template <class elemType>
+bool BSTType<elemType>::Search(const elemType &searchItem, int &key) const
 {
     bool found = false;
 
-    NodeType<elemType> *searchNode = new NodeType<elemType>;
-    searchNode->info = searchItem;
+    NodeType<elemType> *node = FindNode(this->root, searchItem);
 
-    if (SearchNode(this->root, searchNode))
+    if (node != NULL)
     {
-        key = searchNode->key;
+        key = node->key;
         found = true;
     }
     else
@@ -202,31 +467,43 @@ bool BSTType<elemType>::Search(elemType &searchItem, int &key) const
 }
 
 template <class elemType>
-bool BSTType<elemType>::SearchNode(NodeType<elemType>* currentNode, NodeType<elemType>* &searchItem) const
+NodeType<elemType>* BSTType<elemType>::FindNode(NodeType<elemType>* currentNode,
+                                                const elemType &searchItem) const
 {
-    bool found = false;
+    NodeType<elemType> *found = NULL;
 
-    if ((!found) && currentNode != NULL)
+    if (currentNode != NULL)
     {
-        if (currentNode->info == searchItem->info)
-        {
-            searchItem->key = currentNode->key;
-            found = true;
-        }
+        if (currentNode->info == searchItem)
+            found = currentNode;
         else
         {
-            found = SearchNode(currentNode->lLink, searchItem);
+            found = FindNode(currentNode->lLink, searchItem);
 
-            if (!found)
-            {
-                found = SearchNode(currentNode->rLink, searchItem);
-            }
+            if (found == NULL)
+                found = FindNode(currentNode->rLink, searchItem);
         }
     }
-    
+
     return found;
 }
 
+template <class elemType>
+NodeType<elemType>* BSTType<elemType>::FindKey(int key) const
+{
+    NodeType<elemType> *current = this->root;
+
+    while (current != NULL && current->key != key)
+    {
+        if (current->key > key)
+            current = current->lLink;
+        else
+            current = current->rLink;
+    }
+
+    return current;
+}
+
 template <class elemType>
 bool BSTType<elemType>::Navigate(int key, elemType &elemFound, int &keyFound, int direction) const
 {
@@ -255,11 +532,13 @@ bool BSTType<elemType>::Navigate(int key, elemType &elemFound, int &keyFound, in
     if (found && (direction == LEFT_LINK) && (current->lLink != NULL)){
         elemFound = current->lLink->info;
         keyFound = current->lLink->key;
+        CountVisit(current->lLink);
     } 
     else if (found && (direction == RIGHT_LINK) && (current->rLink != NULL))
     {
         elemFound = current->rLink->info;
         keyFound = current->rLink->key;
+        CountVisit(current->rLink);
     }
     else
         found = false;
@@ -339,9 +618,63 @@ void BSTType<elemType>::ScaleNodes(NodeType<elemType> *p, int newScale) {
     }
 }
 
+template <class elemType>
+bool BSTType<elemType>::SetVisitCounting(bool enabled, unsigned int interval)
+{
+	if (interval == 0 || (interval & (interval - 1)) != 0)
+	{
+		cout << "Error: Visit interval must be a power of two." << endl;
+		return false;
+	}
+
+	countVisits = enabled;
+	visitInterval = interval;
+	return true;
+}
+
+template <class elemType>
+void BSTType<elemType>::CountVisit(NodeType<elemType> *node) const
+{
+	if (!countVisits)
+		return;
+
+	if (visitInterval > 1)
+	{
+		visitSeed ^= visitSeed << 13;
+		visitSeed ^= visitSeed >> 17;
+		visitSeed ^= visitSeed << 5;
+
+		if ((visitSeed & (visitInterval - 1)) != 0)
+			return;
+	}
+
+	if (node->visits > UINT_MAX - visitInterval)
+		node->visits = UINT_MAX;
+	else
+		node->visits += visitInterval;
+}
+
 template <class elemType>
 BSTType<elemType>::BSTType()
 {
+	nodeScale = DEFAULT_SCALE;
+	autoRebalance = false;
+	balanceFactor = DEFAULT_BALANCE;
+	countVisits = false;
+	visitInterval = 1;
+	visitSeed = VISIT_SEED;
+}
+
+template <class elemType>
+BSTType<elemType>::BSTType(NodePool<elemType> *pool)
+	: BinaryTreeType<elemType>(pool)
+{
+	nodeScale = DEFAULT_SCALE;
+	autoRebalance = false;
+	balanceFactor = DEFAULT_BALANCE;
+	countVisits = false;
+	visitInterval = 1;
+	visitSeed = VISIT_SEED;
 }
 
 
@@ -350,4 +683,21 @@ BSTType<elemType>::~BSTType()
 {
 }
 
+template <class elemType>
+const BSTType<elemType>& BSTType<elemType>::operator= (const BSTType<elemType>& tree)
+{
+	if (this != &tree)
+	{
+		BinaryTreeType<elemType>::operator=(tree);
+
+		nodeScale = tree.nodeScale;
+		autoRebalance = tree.autoRebalance;
+		balanceFactor = tree.balanceFactor;
+		countVisits = tree.countVisits;
+		visitInterval = tree.visitInterval;
+	}
+
+	return *this;
+}
+
 #endif
@@ -0,0 +1,57 @@
+/*! \file compiledtree.h
+ *  \brief Defines a fixed question and answer tree compiled into a table.
+ *
+ *  Trees that never learn can be converted by qacompile into a static
+ *  table of CompiledQANode entries. The table is built into the program,
+ *  so traversal needs no heap access and no tree file at start up.
+ *
+ *  \author agent
+ *  \version 1.0
+ *  \date 19-OCT-2026
+ *
+ * <pre>
+ *  Revision  Name        Date         Description
+ *  1         agent       19-OCT-2026  Created
+ * </pre>
+*/
+
+#ifndef _COMPILEDTREE_H
+#define	_COMPILEDTREE_H
+
+const int COMPILED_NO_LINK = -1;        // Marks a missing link in a compiled tree
+
+/*! \struct CompiledQANode
+ *  \brief A question or answer in a compiled tree.
+ */
+struct CompiledQANode
+{
+    const char *text;                   // The question or answer text
+    int yesLink;                        // The index of the correct (right) child
+    int noLink;                         // The index of the incorrect (left) child
+};
+
+/*! Returns true if a compiled node is an answer.
+ *  \param tree The compiled tree table.
+ *  \param node The index of the node.
+ *  \retval true If the node has no children.
+ *  \retval false If the node is a question.
+ */
+inline bool CompiledIsAnswer(const CompiledQANode *tree, int node)
+{
+    return (tree[node].yesLink == COMPILED_NO_LINK
+         && tree[node].noLink == COMPILED_NO_LINK);
+}
+
+/*! Returns the next question or answer in a compiled tree. The root of a
+ *  compiled tree is always at index 0.
+ *  \param tree The compiled tree table.
+ *  \param node The index of the current question.
+ *  \param qaPath The path to follow (1 for the correct path, 0 for incorrect).
+ *  \retval index The index of the next node, or COMPILED_NO_LINK if none.
+ */
+inline int CompiledNextQA(const CompiledQANode *tree, int node, int qaPath)
+{
+    return (qaPath != 0) ? tree[node].yesLink : tree[node].noLink;
+}
+
+#endif
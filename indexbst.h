@@ -0,0 +1,499 @@
+/*! \class IndexBSTType
+ *  \brief Defines a binary search tree whose nodes link by 32-bit index.
+ *
+ *  A storage mode for keyed trees holding very many nodes. Rather than
+ *  allocating a NodeType per node, linked by 64-bit pointers, every node
+ *  lives in a growable vector and links to its children by index. Keys
+ *  and links are kept apart from the data: each node's key and two links
+ *  take 12 bytes, where a NodeType spends 24 bytes on its key and links
+ *  alone, and a walk by key reads only the packed keys and links, leaving
+ *  the data untouched until it is needed.
+ *
+ *  The public operations are those of BSTType, with the same semantics and
+ *  error messages, and trees built by the same inserts take the same shape.
+ *  Navigate and IsLeaf, protected in BSTType, are public here. A tree holds
+ *  at most INDEX_MAX_NODES nodes.
+ *
+ *  \author agent
+ *  \version 1.0
+ *  \date 19-OCT-2026
+ *
+ * <pre>
+ *  Revision  Name        Date         Description
+ *  1         agent       19-OCT-2026  Created
+ * </pre>
+*/
+
+#ifndef _INDEXBST_H
+#define	_INDEXBST_H
+
+#include "bsttype.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+using namespace std;
+
+const unsigned int INDEX_NO_LINK = 0xFFFFFFFFu;    // Marks a missing link
+const unsigned int INDEX_MAX_NODES = 0xFFFFFFFEu;  // The most nodes a tree may hold
+
+/*! \struct IndexNode
+ *  \brief The key and links of a node in an IndexBSTType.
+ */
+struct IndexNode
+{
+	int key;                                // A unique key for the node
+	unsigned int lLink;                     // The index of the left child node
+	unsigned int rLink;                     // The index of the right child node
+};
+
+template <class elemType>
+class IndexBSTType
+{
+public:
+
+	/*! Default constructor for an index-linked binary search tree. */
+	IndexBSTType();
+
+	/*! Inserts a new item into the tree.
+	 *  \param newItem The new data to be inserted into the tree.
+	 *  \param key A unique identifier for the item.
+	 */
+	void Insert(const elemType &newItem, int key);
+
+	/*! Searches for an item in the tree depth-first.
+	 *  \param searchItem The search item.
+	 *  \retval key The key of the search item (if found).
+	 *  \retval true If the search item is found.
+	 *  \retval false If the search item is not found.
+	 */
+	bool Search(const elemType &searchItem, int &key) const;
+
+	/*! Searches for a node via key and, if found, replaces info.
+	 *  \param key The uniquely identifying key for the search element.
+	 *  \param newElement The item containing new info.
+	 *  \retval true If the key is found, and info is replaced.
+	 *  \retval false If the key was not found, and info was not replaced.
+	 */
+	bool ReplaceInfo(int key, const elemType &newElement);
+
+	/*! Returns true if a key is held by a node without children.
+	 *  \param key The uniquely identifying key of the node.
+	 */
+	bool IsLeaf(int key) const;
+
+	/*! Attempts returning a child of a designated parent node.
+	 * \param key The uniquely identifying key of the parent node
+	 * \param direction The direction of the link (LEFT_LINK or RIGHT_LINK)
+	 * \retval elemFound The child element, if found
+	 * \retval keyFound The child key, if found
+	 * \retval true If the child is successfully navigated
+	 * \retval false If child navigation is unsuccessful
+	 */
+	bool Navigate(int key, elemType &elemFound, int &keyFound, int direction) const;
+
+	/*! Returns true if the tree is empty. */
+	bool IsEmpty() const;
+
+	/*! Returns the number of nodes in the tree. */
+	int Size() const;
+
+	/*! Returns the height of the tree, counted in nodes (0 if empty). Each
+	 *  call walks every node and costs O(size).
+	 */
+	int Height() const;
+
+	/*! Enables or disables rebalancing on insert, as BSTType::SetRebalance.
+	 *  \param enabled True to rebalance on insert.
+	 *  \param balance The balance factor, greater than 0.5 and less than 1.
+	 *  \retval true If the settings were changed.
+	 *  \retval false If the balance factor is out of range. The settings are
+	 *                 left unchanged.
+	 */
+	bool SetRebalance(bool enabled, double balance = DEFAULT_BALANCE);
+
+	/*! Rebuilds the whole tree into perfect balance. */
+	void Rebalance();
+
+	/*! Reserves room for a number of nodes, so that inserting them does not
+	 *  grow the node vectors.
+	 *  \param count The number of nodes the tree will hold.
+	 */
+	void Reserve(size_t count);
+
+	/*! Returns the bytes each node takes for its key and links. */
+	static size_t LinkBytes();
+
+private:
+
+	/*! Returns the index of the node holding a key, or INDEX_NO_LINK.
+	 * \param key The uniquely identifying key of the node
+	 */
+	unsigned int FindKey(int key) const;
+
+	/*! Searches a subtree depth-first, in the same order as BSTType.
+	 * \param node The index of the root node of the subtree
+	 * \param searchItem The item being searched
+	 * \retval index The first node holding the item, or INDEX_NO_LINK
+	 */
+	unsigned int FindNode(unsigned int node, const elemType &searchItem) const;
+
+	/*! Counts the nodes of a subtree.
+	 * \param node The index of the root node of the subtree.
+	 */
+	int CountNodes(unsigned int node) const;
+
+	/*! Returns the height of a subtree, counted in nodes.
+	 * \param node The index of the root node of the subtree.
+	 */
+	int NodeHeight(unsigned int node) const;
+
+	/*! Rebuilds a subtree into perfect balance.
+	 * \param node The index of the root node of the subtree.
+	 * \retval root The index of the root node of the rebuilt subtree.
+	 */
+	unsigned int RebuildSubtree(unsigned int node);
+
+	/*! Appends the nodes of a subtree to a list in key order.
+	 * \param node The index of the root node of the subtree.
+	 * \param order The list of node indexes.
+	 */
+	void Flatten(unsigned int node, vector<unsigned int> &order) const;
+
+	/*! Links a run of nodes in key order into a perfectly balanced subtree.
+	 * \param order The list of node indexes.
+	 * \param first The position of the first node in the run.
+	 * \param last The position one past the last node in the run.
+	 * \retval root The index of the root node of the subtree.
+	 */
+	unsigned int BuildBalanced(const vector<unsigned int> &order, int first, int last);
+
+	/*! The keys and links of every node, by index. */
+	vector<IndexNode> nodes;
+
+	/*! The data of every node, by index. */
+	vector<elemType> infos;
+
+	/*! The index of the root node, or INDEX_NO_LINK if the tree is empty. */
+	unsigned int root;
+
+	/*! True if inserts rebalance the tree. */
+	bool autoRebalance;
+
+	/*! The scapegoat balance factor used when rebalancing. */
+	double balanceFactor;
+};
+
+template <class elemType>
+IndexBSTType<elemType>::IndexBSTType()
+{
+	root = INDEX_NO_LINK;
+	autoRebalance = false;
+	balanceFactor = DEFAULT_BALANCE;
+}
+
+template <class elemType>
+void IndexBSTType<elemType>::Insert(const elemType &newItem, int key)
+{
+	vector<unsigned int> path;
+	unsigned int current = root;
+	unsigned int parent = INDEX_NO_LINK;
+	unsigned int node;
+	unsigned int child;
+	int childSize;
+	int size;
+	int i;
+
+	if (nodes.size() >= INDEX_MAX_NODES)
+	{
+		cout << "Error: Unable to insert node. Tree is full." << endl;
+		return;
+	}
+
+	/* The path is only kept when a scapegoat may have to be found on it */
+	while (current != INDEX_NO_LINK)
+	{
+		parent = current;
+
+		if (autoRebalance)
+			path.push_back(current);
+
+		if (key < nodes[current].key)
+			current = nodes[current].lLink;
+		else if (key > nodes[current].key)
+			current = nodes[current].rLink;
+		else
+		{
+			cout << "Error: Unable to insert duplicate node." << endl;
+			return;
+		}
+	}
+
+	node = (unsigned int) nodes.size();
+	nodes.push_back(IndexNode());
+	nodes[node].key = key;
+	nodes[node].lLink = INDEX_NO_LINK;
+	nodes[node].rLink = INDEX_NO_LINK;
+	infos.push_back(newItem);
+
+	if (parent == INDEX_NO_LINK)
+	{
+		root = node;
+		return;
+	}
+
+	if (key < nodes[parent].key)
+		nodes[parent].lLink = node;
+	else
+		nodes[parent].rLink = node;
+
+	/* Only a node deeper than the balanced height bound needs a scapegoat */
+	if (autoRebalance
+	 && path.size() > log((double) nodes.size()) / log(1.0 / balanceFactor))
+	{
+		child = node;
+		childSize = 1;
+
+		for (i = (int) path.size() - 1; i >= 0; i--)
+		{
+			size = 1 + childSize + CountNodes((nodes[path[i]].lLink == child)
+			                                  ? nodes[path[i]].rLink : nodes[path[i]].lLink);
+
+			if (childSize > balanceFactor * size)
+			{
+				current = RebuildSubtree(path[i]);
+
+				if (i == 0)
+					root = current;
+				else if (nodes[path[i - 1]].lLink == path[i])
+					nodes[path[i - 1]].lLink = current;
+				else
+					nodes[path[i - 1]].rLink = current;
+
+				break;
+			}
+
+			child = path[i];
+			childSize = size;
+		}
+	}
+}
+
+template <class elemType>
+bool IndexBSTType<elemType>::Search(const elemType &searchItem, int &key) const
+{
+	unsigned int node = FindNode(root, searchItem);
+
+	if (node == INDEX_NO_LINK)
+		return false;
+
+	key = nodes[node].key;
+	return true;
+}
+
+template <class elemType>
+bool IndexBSTType<elemType>::ReplaceInfo(int key, const elemType &newElement)
+{
+	unsigned int node;
+
+	if (root == INDEX_NO_LINK)
+	{
+		cout << "Error: Cannot search an empty tree." << endl;
+		return false;
+	}
+
+	node = FindKey(key);
+
+	if (node == INDEX_NO_LINK)
+		return false;
+
+	infos[node] = newElement;
+	return true;
+}
+
+template <class elemType>
+bool IndexBSTType<elemType>::IsLeaf(int key) const
+{
+	unsigned int node = FindKey(key);
+
+	return (node != INDEX_NO_LINK
+	     && nodes[node].lLink == INDEX_NO_LINK && nodes[node].rLink == INDEX_NO_LINK);
+}
+
+template <class elemType>
+bool IndexBSTType<elemType>::Navigate(int key, elemType &elemFound, int &keyFound,
+                                      int direction) const
+{
+	unsigned int node;
+	unsigned int child = INDEX_NO_LINK;
+
+	if (root == INDEX_NO_LINK)
+	{
+		cout << "Error: Cannot search an empty tree." << endl;
+		return false;
+	}
+
+	node = FindKey(key);
+
+	if (node != INDEX_NO_LINK && direction == LEFT_LINK)
+		child = nodes[node].lLink;
+	else if (node != INDEX_NO_LINK && direction == RIGHT_LINK)
+		child = nodes[node].rLink;
+
+	if (child == INDEX_NO_LINK)
+		return false;
+
+	elemFound = infos[child];
+	keyFound = nodes[child].key;
+	return true;
+}
+
+template <class elemType>
+bool IndexBSTType<elemType>::IsEmpty() const
+{
+	return (root == INDEX_NO_LINK);
+}
+
+template <class elemType>
+int IndexBSTType<elemType>::Size() const
+{
+	return (int) nodes.size();
+}
+
+template <class elemType>
+int IndexBSTType<elemType>::Height() const
+{
+	return NodeHeight(root);
+}
+
+template <class elemType>
+bool IndexBSTType<elemType>::SetRebalance(bool enabled, double balance)
+{
+	/* At 0.5 no tree is balanced enough; at 1 no insert ever finds a scapegoat */
+	if (!(balance > 0.5 && balance < 1.0))
+	{
+		cout << "Error: Balance factor must be between 0.5 and 1." << endl;
+		return false;
+	}
+
+	autoRebalance = enabled;
+	balanceFactor = balance;
+
+	return true;
+}
+
+template <class elemType>
+void IndexBSTType<elemType>::Rebalance()
+{
+	root = RebuildSubtree(root);
+}
+
+template <class elemType>
+void IndexBSTType<elemType>::Reserve(size_t count)
+{
+	nodes.reserve(count);
+	infos.reserve(count);
+}
+
+template <class elemType>
+size_t IndexBSTType<elemType>::LinkBytes()
+{
+	return sizeof(IndexNode);
+}
+
+template <class elemType>
+unsigned int IndexBSTType<elemType>::FindKey(int key) const
+{
+	unsigned int current = root;
+
+	while (current != INDEX_NO_LINK && nodes[current].key != key)
+	{
+		if (nodes[current].key > key)
+			current = nodes[current].lLink;
+		else
+			current = nodes[current].rLink;
+	}
+
+	return current;
+}
+
+template <class elemType>
+unsigned int IndexBSTType<elemType>::FindNode(unsigned int node,
+                                              const elemType &searchItem) const
+{
+	unsigned int found = INDEX_NO_LINK;
+
+	if (node != INDEX_NO_LINK)
+	{
+		if (infos[node] == searchItem)
+			found = node;
+		else
+		{
+			found = FindNode(nodes[node].lLink, searchItem);
+
+			if (found == INDEX_NO_LINK)
+				found = FindNode(nodes[node].rLink, searchItem);
+		}
+	}
+
+	return found;
+}
+
+template <class elemType>
+int IndexBSTType<elemType>::CountNodes(unsigned int node) const
+{
+	if (node == INDEX_NO_LINK)
+		return 0;
+
+	return 1 + CountNodes(nodes[node].lLink) + CountNodes(nodes[node].rLink);
+}
+
+template <class elemType>
+int IndexBSTType<elemType>::NodeHeight(unsigned int node) const
+{
+	if (node == INDEX_NO_LINK)
+		return 0;
+
+	return 1 + max(NodeHeight(nodes[node].lLink), NodeHeight(nodes[node].rLink));
+}
+
+template <class elemType>
+unsigned int IndexBSTType<elemType>::RebuildSubtree(unsigned int node)
+{
+	vector<unsigned int> order;
+
+	Flatten(node, order);
+
+	return BuildBalanced(order, 0, (int) order.size());
+}
+
+template <class elemType>
+void IndexBSTType<elemType>::Flatten(unsigned int node, vector<unsigned int> &order) const
+{
+	if (node != INDEX_NO_LINK)
+	{
+		Flatten(nodes[node].lLink, order);
+		order.push_back(node);
+		Flatten(nodes[node].rLink, order);
+	}
+}
+
+template <class elemType>
+unsigned int IndexBSTType<elemType>::BuildBalanced(const vector<unsigned int> &order,
+                                                   int first, int last)
+{
+	unsigned int node = INDEX_NO_LINK;
+	int middle;
+
+	if (first < last)
+	{
+		middle = first + (last - first) / 2;
+		node = order[middle];
+		nodes[node].lLink = BuildBalanced(order, first, middle);
+		nodes[node].rLink = BuildBalanced(order, middle + 1, last);
+	}
+
+	return node;
+}
+
+#endif
@@ -33,21 +33,47 @@
  *  - Incorrect file locations will raise an error and exit the program.
  *  - Incorrect input from yes/ no prompts will raise an error message
  *    and prompt the user for correct input.
- * Errors:
- *  - Input files must include a new line before the end of the file.
+ *  - The last record of an input file may omit its new line.
  *
  * Files
  * -----------------------------------------------------------------
  * Headers: 
+ *  - nodepool.h
  *  - binarytree.h
  *  - bsttype.h
+ *  - indexbst.h
  *  - qatree.h
+ *  - compiledtree.h
+ *  - qaforest.h
+ *  - qasession.h
+ *  - qasnapshot.h
+ *  - qaimage.h
+ *  - qafile.h
+ *  - qalearnqueue.h
+ *  - qaloader.h
  * Source:
  *  - main.cpp
  *  - qatree.cpp
+ *  - qaforest.cpp
+ *  - qasession.cpp
+ *  - qasnapshot.cpp
+ *  - qaimage.cpp
+ *  - qafile.cpp
+ *  - qalearnqueue.cpp
+ *  - qaloader.cpp
+ * Tools:
+ *  - qacompile.cpp (with qatree.cpp and qafile.cpp)
+ *  - qaserver.cpp (Linux, C++20, with qatree.cpp, qasession.cpp, qafile.cpp
+ *    and qaloader.cpp)
+ *  - qaload.cpp (Linux)
+ * Benchmarks:
+ *  - BSTBench.cpp
+ *  - QATreeBench.cpp (with qatree.cpp, qalearnqueue.cpp and qaloader.cpp)
  * Test:
  *  - BSTTest.cpp
- *  - QATreeTest.cpp
+ *  - QATreeTest.cpp (with qatree.cpp, qaforest.cpp, qaloader.cpp,
+ *    qaimage.cpp, qasnapshot.cpp and qafile.cpp)
+ *  - QALearnQueueTest.cpp
  */
 
 #include <iostream>
@@ -55,13 +81,14 @@
 #include <fstream>
 #include <stdlib.h>
 #include "qatree.h"
+#include "qafile.h"
 
 using namespace std;
 
 bool SaveTreeToFile(string fname, QATree &tree);
 bool LoadTreeFromFile(string fname, QATree &tree);
 void PromptNewObject(QATree &qatree, string &alternateAnswer);
-void PromptQuestion(QATree &qatree, string &question, string &input);
+void PromptQuestion(QATree &qatree, string &question, int key, string &input);
 void PromptSave(QATree &qatree);
 
 int main(int argc, char** argv) {
@@ -74,6 +101,7 @@ int main(int argc, char** argv) {
 	string answer;				 // Tree answer
 	string newQuestion;			 // New question input
 	string newAnswer;			 // New answer input
+	int key = 0;				 // The key of the tree question
 
 	bool finished = false;		 // Determines whether program has finished
 	bool exit = false;			 // Determines whether user wishes to exit
@@ -97,7 +125,7 @@ int main(int argc, char** argv) {
 			 << endl << endl;
 
 		/* Return the first question in the tree */
-		if (!qatree.GetFirstQA(question))
+		if (!qatree.GetFirstQA(question, key))
 		{
 			cout << "Error: No root node defined. " << endl;
 			return (EXIT_FAILURE);
@@ -105,10 +133,10 @@ int main(int argc, char** argv) {
 
 		while (!finished && !exit && !inputError) 
 		{
-			PromptQuestion(qatree, question, input);
+			PromptQuestion(qatree, question, key, input);
 
 			/* If an answer was proposed */
-			if (qatree.IsAnswer(question)) 
+			if (qatree.IsAnswer(question, key)) 
 			{
 				/* If the user answers "yes", finish this round. */
 				if (input == "y" || input == "Y") 
@@ -132,12 +160,12 @@ int main(int argc, char** argv) {
 			{
 				if (input == "y" || input == "Y") 
 				{
-					qatree.GetNextQA(question, answer, CORRECT_PATH);
+					qatree.GetNextQA(question, key, answer, CORRECT_PATH);
 					question = answer;
 				} 
 				else if (input == "n" || input == "N") 
 				{
-					qatree.GetNextQA(question, answer, INCORRECT_PATH);
+					qatree.GetNextQA(question, key, answer, INCORRECT_PATH);
 					question = answer;
 				}
 			}
@@ -223,14 +251,14 @@ void PromptNewObject(QATree &qatree, string &alternateAnswer)
 	cout << endl;
 }
 
-void PromptQuestion(QATree &qatree, string &question, string &input)
+void PromptQuestion(QATree &qatree, string &question, int key, string &input)
 {
 	bool inputError;
 	
 	do {
 		inputError = false;
 
-		if (qatree.IsAnswer(question))
+		if (qatree.IsAnswer(question, key))
 			cout << "I guess that your object is a(n) " << question << "? (Y or N): ";
 		else
 			cout << question << " ";
@@ -251,16 +279,7 @@ void PromptQuestion(QATree &qatree, string &question, string &input)
 
 bool SaveTreeToFile(string fname, QATree &tree) {
 
-	ofstream ofile;
-	ofile.open(fname.c_str());
-
-	if (!ofile)
-		return false;
-
-	ofile << tree;
-	ofile.close();
-
-	return true;
+	return QAFile::SaveTree(tree, fname);
 }
 
 bool LoadTreeFromFile(string fname, QATree &tree) {
@@ -270,10 +289,7 @@ bool LoadTreeFromFile(string fname, QATree &tree) {
 	if (!ifile)
 		return false;
 
-	while (ifile) {
-		if (ifile.peek() != '\n' && !ifile.eof())
-			ifile >> tree;
-	}
+	tree.LoadRecords(ifile);
 
 	ifile.close();
 
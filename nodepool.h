@@ -0,0 +1,357 @@
+/*! \class NodePool
+ *  \brief Allocates binary tree nodes from contiguous blocks.
+ *
+ *  Nodes are carved from blocks rather than being allocated one at a time,
+ *  which keeps neighbouring nodes close together in memory. Blocks start at
+ *  FIRST_BLOCK_SIZE nodes and double up to NODE_BLOCK_SIZE, so small trees
+ *  stay small; Reserve sizes a block to a whole tree. Released nodes are
+ *  kept on a free list for reuse. Every block is freed with the pool, or
+ *  handed to the pool's NodeBlockCache, if it has one, for another pool to
+ *  reuse.
+ *
+ *  Nodes keep full pointer links. Keyed trees too large for them can use
+ *  IndexBSTType (see indexbst.h), which links nodes by 32-bit index.
+ *
+ *  \author agent
+ *  \version 4.0
+ *  \date 19-OCT-2026
+ *
+ * <pre>
+ *  Revision  Name        Date         Description
+ *  1         agent       19-OCT-2026  Created
+ *  2         agent       19-OCT-2026  Added Swap function
+ *  3         agent       19-OCT-2026  Blocks grow from FIRST_BLOCK_SIZE.
+ *                                     Added Reserve function
+ *  4         agent       19-OCT-2026  Added NodeBlockCache. Reserved nodes
+ *                                     bypass the free list.
+ * </pre>
+*/
+
+#ifndef _NODEPOOL_H
+#define	_NODEPOOL_H
+
+#include <vector>
+#include <algorithm>
+#include <stddef.h>
+
+using namespace std;
+
+const int FIRST_BLOCK_SIZE = 4;                 // The number of nodes in the first pool block
+const int NODE_BLOCK_SIZE = 256;                // The largest number of nodes in a growing pool block
+
+const int BLOCK_CACHE_SIZE = 64;                // The default number of blocks a cache keeps
+
+template <class elemType> struct NodeType;
+
+/*! \class NodeBlockCache
+ *  \brief Keeps the blocks of freed node pools for other pools to reuse.
+ *
+ *  Only full NODE_BLOCK_SIZE blocks are kept, and only up to a limit;
+ *  blocks beyond it are freed, so the memory of pools that are gone is
+ *  returned rather than held forever.
+ */
+template <class elemType>
+class NodeBlockCache
+{
+public:
+	/*! Constructor for a block cache.
+	 *  \param limit The most blocks the cache keeps.
+	 */
+	NodeBlockCache(size_t limit = BLOCK_CACHE_SIZE);
+
+	/*! Destructor for a block cache. Frees every cached block. */
+	~NodeBlockCache();
+
+	/*! Returns a cached block of NODE_BLOCK_SIZE nodes, or NULL if none is
+	 *  cached. */
+	NodeType<elemType>* Take();
+
+	/*! Caches a block of NODE_BLOCK_SIZE nodes, or frees it if the cache is
+	 *  full. The data of its nodes is dropped either way.
+	 *  \param block The block being given up.
+	 */
+	void Give(NodeType<elemType> *block);
+
+	/*! Returns the number of bytes held by cached blocks. */
+	size_t Capacity() const;
+
+private:
+
+	/*! Block caches own their blocks and cannot be copied. */
+	NodeBlockCache(const NodeBlockCache<elemType>& cache);
+	const NodeBlockCache& operator= (const NodeBlockCache<elemType>& cache);
+
+	/*! The cached blocks. */
+	vector< NodeType<elemType>* > blocks;
+
+	/*! The most blocks the cache keeps. */
+	size_t blockLimit;
+};
+
+template <class elemType>
+class NodePool
+{
+public:
+	/*! Default constructor for a node pool. */
+	NodePool();
+
+	/*! Constructor for a node pool that reuses, and gives up, full blocks
+	 *  through a cache.
+	 *  \param cache The cache to take blocks from. It must outlive the pool.
+	 */
+	NodePool(NodeBlockCache<elemType> *cache);
+
+	/*! Destructor for a node pool. Frees every block. */
+	~NodePool();
+
+	/*! Returns a node with default info and null links. */
+	NodeType<elemType>* Allocate();
+
+	/*! Returns a node to the pool for reuse.
+	 *  \param node The node being released.
+	 */
+	void Release(NodeType<elemType> *node);
+
+	/*! Makes room for a number of nodes in one block, so that the next
+	 *  nodes allocated are contiguous. Until they have been allocated, the
+	 *  free list is not used. Unused nodes left in the current block are not
+	 *  reused.
+	 *  \param count The number of nodes about to be allocated.
+	 */
+	void Reserve(size_t count);
+
+	/*! Exchanges the blocks of two pools.
+	 *  \param pool The pool to exchange blocks with.
+	 */
+	void Swap(NodePool<elemType> &pool);
+
+	/*! Returns the number of nodes currently allocated from the pool. */
+	size_t InUse() const;
+
+	/*! Returns the number of bytes held by the pool's blocks. */
+	size_t Capacity() const;
+
+private:
+
+	/*! Node pools own their blocks and cannot be copied. */
+	NodePool(const NodePool<elemType>& pool);
+	const NodePool& operator= (const NodePool<elemType>& pool);
+
+	/*! Adds a block of nodes to the pool and makes it current.
+	 *  \param size The number of nodes in the block.
+	 */
+	void AddBlock(int size);
+
+	/*! The blocks of nodes owned by the pool. */
+	vector< NodeType<elemType>* > blocks;
+
+	/*! The number of nodes in each block. */
+	vector<int> blockSizes;
+
+	/*! The cache blocks are taken from and given to, or NULL. */
+	NodeBlockCache<elemType> *blockCache;
+
+	/*! The number of nodes in the most recent block. */
+	int blockSize;
+
+	/*! The number of nodes in every block. */
+	size_t nodeCapacity;
+
+	/*! Released nodes, chained through their left links. */
+	NodeType<elemType> *freeList;
+
+	/*! The next unused node in the most recent block. */
+	int nextSlot;
+
+	/*! The reserved nodes not yet allocated. */
+	size_t reserved;
+
+	/*! The number of nodes currently allocated. */
+	size_t inUse;
+};
+
+template <class elemType>
+NodeBlockCache<elemType>::NodeBlockCache(size_t limit)
+{
+	blockLimit = limit;
+}
+
+template <class elemType>
+NodeBlockCache<elemType>::~NodeBlockCache()
+{
+	for (size_t i = 0; i < blocks.size(); i++)
+		delete [] blocks[i];
+}
+
+template <class elemType>
+NodeType<elemType>* NodeBlockCache<elemType>::Take()
+{
+	NodeType<elemType> *block = NULL;
+
+	if (!blocks.empty())
+	{
+		block = blocks.back();
+		blocks.pop_back();
+	}
+
+	return block;
+}
+
+template <class elemType>
+void NodeBlockCache<elemType>::Give(NodeType<elemType> *block)
+{
+	if (blocks.size() >= blockLimit)
+	{
+		delete [] block;
+		return;
+	}
+
+	/* Nodes still holding data when their pool went away must not keep it */
+	for (int i = 0; i < NODE_BLOCK_SIZE; i++)
+		block[i].info = elemType();
+
+	blocks.push_back(block);
+}
+
+template <class elemType>
+size_t NodeBlockCache<elemType>::Capacity() const
+{
+	return blocks.size() * NODE_BLOCK_SIZE * sizeof(NodeType<elemType>);
+}
+
+template <class elemType>
+NodePool<elemType>::NodePool()
+{
+	blockCache = NULL;
+	freeList = NULL;
+	blockSize = 0;
+	nextSlot = 0;
+	reserved = 0;
+	nodeCapacity = 0;
+	inUse = 0;
+}
+
+template <class elemType>
+NodePool<elemType>::NodePool(NodeBlockCache<elemType> *cache)
+{
+	blockCache = cache;
+	freeList = NULL;
+	blockSize = 0;
+	nextSlot = 0;
+	reserved = 0;
+	nodeCapacity = 0;
+	inUse = 0;
+}
+
+template <class elemType>
+NodePool<elemType>::~NodePool()
+{
+	for (size_t i = 0; i < blocks.size(); i++)
+	{
+		if (blockCache != NULL && blockSizes[i] == NODE_BLOCK_SIZE)
+			blockCache->Give(blocks[i]);
+		else
+			delete [] blocks[i];
+	}
+}
+
+template <class elemType>
+NodeType<elemType>* NodePool<elemType>::Allocate()
+{
+	NodeType<elemType> *node;
+
+	if (freeList != NULL && reserved == 0)
+	{
+		node = freeList;
+		freeList = freeList->lLink;
+	}
+	else
+	{
+		if (nextSlot == blockSize)
+		{
+			if (blockSize == 0)
+				AddBlock(FIRST_BLOCK_SIZE);
+			else
+				AddBlock(min(blockSize * 2, NODE_BLOCK_SIZE));
+		}
+
+		node = &blocks.back()[nextSlot++];
+
+		if (reserved > 0)
+			reserved--;
+	}
+
+	node->key = 0;
+	node->visits = 0;
+	node->lLink = NULL;
+	node->rLink = NULL;
+	inUse++;
+
+	return node;
+}
+
+template <class elemType>
+void NodePool<elemType>::Release(NodeType<elemType> *node)
+{
+	/* Drop the node's data now rather than when the block is freed */
+	node->info = elemType();
+	node->rLink = NULL;
+	node->lLink = freeList;
+	freeList = node;
+	inUse--;
+}
+
+template <class elemType>
+void NodePool<elemType>::Reserve(size_t count)
+{
+	if (count > (size_t) (blockSize - nextSlot))
+		AddBlock((int) count);
+
+	reserved = count;
+}
+
+template <class elemType>
+void NodePool<elemType>::AddBlock(int size)
+{
+	NodeType<elemType> *block = NULL;
+
+	if (blockCache != NULL && size == NODE_BLOCK_SIZE)
+		block = blockCache->Take();
+
+	if (block == NULL)
+		block = new NodeType<elemType>[size];
+
+	blocks.push_back(block);
+	blockSizes.push_back(size);
+	blockSize = size;
+	nextSlot = 0;
+	nodeCapacity += size;
+}
+
+template <class elemType>
+void NodePool<elemType>::Swap(NodePool<elemType> &pool)
+{
+	blocks.swap(pool.blocks);
+	blockSizes.swap(pool.blockSizes);
+
+	swap(freeList, pool.freeList);
+	swap(blockSize, pool.blockSize);
+	swap(nextSlot, pool.nextSlot);
+	swap(reserved, pool.reserved);
+	swap(nodeCapacity, pool.nodeCapacity);
+	swap(inUse, pool.inUse);
+}
+
+template <class elemType>
+size_t NodePool<elemType>::InUse() const
+{
+	return inUse;
+}
+
+template <class elemType>
+size_t NodePool<elemType>::Capacity() const
+{
+	return nodeCapacity * sizeof(NodeType<elemType>);
+}
+
+#endif
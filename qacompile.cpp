@@ -0,0 +1,94 @@
+/*! \file qacompile.cpp
+ *  \brief Compiles a saved decision tree into a C++ table.
+ *
+ * Reads a decision tree file, in the format written by ObjectGuess, and
+ * writes a header holding the tree as a static CompiledQANode table.
+ * Programs that ship a fixed tree include the generated header and
+ * traverse it with the functions in compiledtree.h.
+ *
+ * With -image, a binary image is written instead. Any number of
+ * processes can map the image read-only through QAImage. The image is
+ * written under a temporary name and renamed over the output, so
+ * processes that have the previous image mapped keep reading it.
+ *
+ * Usage: qacompile <input file> <output header> [table name]
+ *        qacompile -image <input file> <output image>
+ *
+ * Build: g++ -o qacompile qacompile.cpp qatree.cpp qafile.cpp
+ *
+ * \author agent
+ * \date 19-OCT-2026
+ */
+
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <stdlib.h>
+#include "qatree.h"
+#include "qafile.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+
+	QATree qatree;				 // Tree loaded from the input file
+	string name = "compiledTree";	 // Name of the generated table
+	bool image = false;			 // Determines whether an image is written
+
+	if (argc > 1 && string(argv[1]) == "-image") {
+		image = true;
+		argc--;
+		argv++;
+	}
+
+	if (argc < 3 || argc > 4 || (image && argc != 3)) {
+		cout << "Usage: qacompile <input file> <output header> [table name]" << endl
+			 << "       qacompile -image <input file> <output image>" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	if (argc == 4)
+		name = argv[3];
+
+	ifstream ifile(argv[1]);
+
+	if (!ifile) {
+		cout << "Error: Unable to locate input file" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	qatree.LoadRecords(ifile);
+	ifile.close();
+
+	if (qatree.IsEmpty()) {
+		cout << "Error: No root node defined. " << endl;
+		return (EXIT_FAILURE);
+	}
+
+	/* Truncating a mapped image in place would fault the processes mapping it */
+	if (image) {
+		if (!QAFile::SaveImage(qatree, argv[2])) {
+			cout << "Error: Unable to write output image" << endl;
+			return (EXIT_FAILURE);
+		}
+
+		return (EXIT_SUCCESS);
+	}
+
+	ofstream ofile(argv[2]);
+
+	if (!ofile) {
+		cout << "Error: Unable to resolve output path" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	qatree.WriteCompiledTable(ofile, name);
+	ofile.close();
+
+	if (ofile.fail()) {
+		cout << "Error: Unable to write output file" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,119 @@
+#include "qafile.h"
+#include <fstream>
+#include <cstdio>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+bool QAFile::SaveTree(const QATree &tree, const string &fname)
+{
+    string tempName = fname + ".tmp";
+    bool written;
+    int fd;
+
+#ifdef _WIN32
+    fd = _open(tempName.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+#else
+    fd = open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+
+    if (fd < 0)
+        return false;
+
+#ifdef _WIN32
+    written = tree.WriteRecords(fd) && _commit(fd) == 0;
+    written = (_close(fd) == 0) && written;
+#else
+    written = tree.WriteRecords(fd) && fsync(fd) == 0;
+    written = (close(fd) == 0) && written;
+#endif
+
+    /* The target is untouched, so only the partial temporary file is lost */
+    if (!written)
+    {
+        remove(tempName.c_str());
+        return false;
+    }
+
+    return Replace(tempName, fname);
+}
+
+bool QAFile::SaveImage(const QATree &tree, const string &fname)
+{
+    string tempName = fname + ".tmp";
+    ofstream ofile(tempName.c_str(), ios::out | ios::binary);
+
+    if (!ofile)
+        return false;
+
+    tree.WriteImage(ofile);
+    ofile.close();
+
+    if (ofile.fail() || !Sync(tempName))
+    {
+        remove(tempName.c_str());
+        return false;
+    }
+
+    return Replace(tempName, fname);
+}
+
+bool QAFile::Sync(const string &fname)
+{
+    bool synced;
+    int fd;
+
+#ifdef _WIN32
+    fd = _open(fname.c_str(), _O_RDWR | _O_BINARY);
+#else
+    fd = open(fname.c_str(), O_RDWR);
+#endif
+
+    if (fd < 0)
+        return false;
+
+#ifdef _WIN32
+    synced = (_commit(fd) == 0);
+    _close(fd);
+#else
+    synced = (fsync(fd) == 0);
+    close(fd);
+#endif
+
+    return synced;
+}
+
+bool QAFile::Replace(const string &tempName, const string &fname)
+{
+#ifdef _WIN32
+    /* rename will not replace an existing file on Windows */
+    return MoveFileExA(tempName.c_str(), fname.c_str(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    string dirName = ".";
+    size_t slash = fname.rfind('/');
+    int fd;
+
+    if (rename(tempName.c_str(), fname.c_str()) != 0)
+        return false;
+
+    if (slash != string::npos)
+        dirName = fname.substr(0, slash + 1);
+
+    /* The rename is only durable once the directory entry is on disk */
+    fd = open(dirName.c_str(), O_RDONLY);
+
+    if (fd >= 0)
+    {
+        fsync(fd);
+        close(fd);
+    }
+
+    return true;
+#endif
+}
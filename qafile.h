@@ -0,0 +1,66 @@
+/*! \class QAFile
+ *  \brief Saves question and answer trees by atomic file replacement.
+ *
+ *  Each file is written under a temporary name, flushed to disk and then
+ *  renamed over the target, so the target always holds either the previous
+ *  save or the new one, even if the program or the machine stops part way.
+ *  The target is never removed. If the rename fails, the new save is kept
+ *  under the temporary name, the target name with ".tmp" appended.
+ *
+ *  \author agent
+ *  \version 1.0
+ *  \date 19-OCT-2026
+ *
+ * <pre>
+ *  Revision  Name        Date         Description
+ *  1         agent       19-OCT-2026  Created
+ * </pre>
+ */
+
+#ifndef _QAFILE_H
+#define	_QAFILE_H
+
+#include "qatree.h"
+#include <string>
+
+class QAFile
+{
+public:
+
+	/*! Saves a tree as "key text" records, the format LoadRecords reads.
+	 *  \param tree The tree to save.
+	 *  \param fname The file to save the tree to.
+	 *  \retval true If the tree is saved.
+	 *  \retval false If the file could not be written or replaced.
+	 */
+    static bool SaveTree(const QATree &tree, const string &fname);
+
+	/*! Saves a tree as a binary image that QAImage can map. Processes that
+	 *  have the previous image mapped keep reading it unchanged.
+	 *  \param tree The tree to save.
+	 *  \param fname The file to save the image to.
+	 *  \retval true If the image is saved.
+	 *  \retval false If the file could not be written or replaced.
+	 */
+    static bool SaveImage(const QATree &tree, const string &fname);
+
+private:
+
+	/*! Flushes a written file to disk.
+	 *  \param fname The file to flush.
+	 *  \retval true If the file is on disk.
+	 *  \retval false If the file could not be opened or flushed.
+	 */
+    static bool Sync(const string &fname);
+
+	/*! Renames a flushed temporary file over the target, and flushes the
+	 *  directory holding it so the new name is on disk too.
+	 *  \param tempName The temporary file.
+	 *  \param fname The file to replace.
+	 *  \retval true If the target was replaced.
+	 *  \retval false If the rename failed. The temporary file is kept.
+	 */
+    static bool Replace(const string &tempName, const string &fname);
+};
+
+#endif
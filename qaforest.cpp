@@ -0,0 +1,212 @@
+#include "qaforest.h"
+#include <fstream>
+
+QATreeForest::QATreeForest()
+{
+    sharedBytes = 0;
+    parkedRecords = 0;
+}
+
+QATreeForest::~QATreeForest()
+{
+    map<string, QATenant>::iterator it;
+
+    for (it = tenants.begin(); it != tenants.end(); it++)
+        Clear(it->second);
+}
+
+bool QATreeForest::Load(const string &name, const string &fname)
+{
+    ifstream ifile(fname.c_str());
+    QATenant tenant;
+
+    if (!ifile)
+        return false;
+
+    tenant.pool = new NodePool<string>(&blockCache);
+    tenant.tree = new QATree(tenant.pool);
+
+    tenant.tree->LoadRecords(ifile);
+    ifile.close();
+
+    Unload(name);
+    tenants[name] = tenant;
+
+    return true;
+}
+
+bool QATreeForest::Unload(const string &name)
+{
+    map<string, QATenant>::iterator it = tenants.find(name);
+
+    if (it == tenants.end())
+        return false;
+
+    Clear(it->second);
+    tenants.erase(it);
+
+    return true;
+}
+
+bool QATreeForest::Park(const string &name)
+{
+    map<string, QATenant>::iterator it = tenants.find(name);
+    vector<const StringNode*> pending;
+    const StringNode *node;
+    QAParkedRecord record;
+
+    if (it == tenants.end())
+        return false;
+
+    QATenant &tenant = it->second;
+
+    if (tenant.tree == NULL)
+        return true;
+
+    if (tenant.tree->root != NULL)
+        pending.push_back(tenant.tree->root);
+
+    tenant.parked.reserve(tenant.tree->Size());
+
+    /* Preorder, so that inserting the records in order rebuilds the tree */
+    while (!pending.empty())
+    {
+        node = pending.back();
+        pending.pop_back();
+
+        record.key = node->key;
+        record.text = ShareText(node->info);
+        tenant.parked.push_back(record);
+
+        if (node->rLink != NULL)
+            pending.push_back(node->rLink);
+
+        if (node->lLink != NULL)
+            pending.push_back(node->lLink);
+    }
+
+    parkedRecords += tenant.parked.size();
+
+    delete tenant.tree;
+    delete tenant.pool;
+    tenant.tree = NULL;
+    tenant.pool = NULL;
+
+    return true;
+}
+
+QATree* QATreeForest::Find(const string &name)
+{
+    map<string, QATenant>::iterator it = tenants.find(name);
+    size_t i;
+
+    if (it == tenants.end())
+        return NULL;
+
+    QATenant &tenant = it->second;
+
+    if (tenant.tree == NULL)
+    {
+        tenant.pool = new NodePool<string>(&blockCache);
+        tenant.tree = new QATree(tenant.pool);
+
+        for (i = 0; i < tenant.parked.size(); i++)
+        {
+            tenant.tree->Insert(*tenant.parked[i].text, tenant.parked[i].key);
+            ReleaseText(tenant.parked[i].text);
+        }
+
+        parkedRecords -= tenant.parked.size();
+        vector<QAParkedRecord>().swap(tenant.parked);
+    }
+
+    return tenant.tree;
+}
+
+size_t QATreeForest::TreeCount() const
+{
+    return tenants.size();
+}
+
+size_t QATreeForest::ParkedCount() const
+{
+    map<string, QATenant>::const_iterator it;
+    size_t count = 0;
+
+    for (it = tenants.begin(); it != tenants.end(); it++)
+        if (it->second.tree == NULL)
+            count++;
+
+    return count;
+}
+
+size_t QATreeForest::NodesInUse() const
+{
+    map<string, QATenant>::const_iterator it;
+    size_t count = 0;
+
+    for (it = tenants.begin(); it != tenants.end(); it++)
+        if (it->second.pool != NULL)
+            count += it->second.pool->InUse();
+
+    return count;
+}
+
+size_t QATreeForest::NodeBytes() const
+{
+    map<string, QATenant>::const_iterator it;
+    size_t bytes = blockCache.Capacity();
+
+    for (it = tenants.begin(); it != tenants.end(); it++)
+        if (it->second.pool != NULL)
+            bytes += it->second.pool->Capacity();
+
+    return bytes;
+}
+
+size_t QATreeForest::ParkedBytes() const
+{
+    return parkedRecords * sizeof(QAParkedRecord) + sharedBytes;
+}
+
+void QATreeForest::Clear(QATenant &tenant)
+{
+    /* The tree goes first, returning its nodes before its pool is freed */
+    delete tenant.tree;
+    delete tenant.pool;
+    tenant.tree = NULL;
+    tenant.pool = NULL;
+
+    for (size_t i = 0; i < tenant.parked.size(); i++)
+        ReleaseText(tenant.parked[i].text);
+
+    parkedRecords -= tenant.parked.size();
+    tenant.parked.clear();
+}
+
+const string* QATreeForest::ShareText(const string &text)
+{
+    map<string, int>::iterator it = sharedText.find(text);
+
+    if (it == sharedText.end())
+    {
+        it = sharedText.insert(make_pair(text, 0)).first;
+        sharedBytes += text.size();
+    }
+
+    it->second++;
+
+    /* Keys of a map never move, so the shared text stays put */
+    return &it->first;
+}
+
+void QATreeForest::ReleaseText(const string *text)
+{
+    map<string, int>::iterator it = sharedText.find(*text);
+
+    if (it != sharedText.end() && --it->second == 0)
+    {
+        sharedBytes -= it->first.size();
+        sharedText.erase(it);
+    }
+}
@@ -0,0 +1,154 @@
+/*! \class QATreeForest
+ *  \brief Hosts many named question and answer trees.
+ *
+ *  Each loaded tree allocates its nodes from its own NodePool, so unloading
+ *  a tree frees all of its nodes at once. Full blocks freed this way are
+ *  kept in a NodeBlockCache shared by the whole forest, up to a limit, for
+ *  the next tree loaded to reuse.
+ *
+ *  Trees that are not in use can be parked. A parked tree keeps only a key
+ *  and a text reference per node. Every text is held once, in a table
+ *  shared by the whole forest, however many parked trees hold it, so
+ *  tenants grown from the same base tree share most of their text. A
+ *  parked tree is rebuilt the next time it is found.
+ *
+ *  \author agent
+ *  \version 2.0
+ *  \date 19-OCT-2026
+ *
+ * <pre>
+ *  Revision  Name        Date         Description
+ *  1         agent       19-OCT-2026  Created
+ *  2         agent       19-OCT-2026  Trees have their own pools, taking
+ *                                     blocks from a shared cache. Added Park
+ *                                     and shared text for parked trees.
+ * </pre>
+ */
+
+#ifndef _QAFOREST_H
+#define	_QAFOREST_H
+
+#include "qatree.h"
+#include <string>
+#include <vector>
+#include <map>
+
+/*! \struct QAParkedRecord
+ *  \brief A node of a parked tree.
+ */
+struct QAParkedRecord
+{
+    int key;                            // The key of the node
+    const string *text;                 // The node's text, in the shared table
+};
+
+/*! \struct QATenant
+ *  \brief A tree hosted by a forest, loaded or parked.
+ */
+struct QATenant
+{
+    NodePool<string> *pool;             // The pool of the loaded tree, or NULL
+    QATree *tree;                       // The loaded tree, or NULL if parked
+    vector<QAParkedRecord> parked;      // The parked tree's nodes, in preorder
+};
+
+class QATreeForest
+{
+public:
+
+	/*! Default constructor for QATreeForest */
+    QATreeForest();
+
+	/*! Default destructor for QATreeForest. Unloads every tree. */
+    ~QATreeForest();
+
+	/*! Loads a tree from a file and hosts it under a name. A tree already
+	 *  hosted under the same name is replaced.
+	 *  \param name The name of the tree.
+	 *  \param fname The file holding the tree records.
+	 *  \retval true If the file is found and the tree is loaded.
+	 *  \retval false If the file cannot be opened.
+	 */
+    bool Load(const string &name, const string &fname);
+
+	/*! Unloads a tree, freeing its nodes.
+	 *  \param name The name of the tree.
+	 *  \retval true If the tree was hosted and has been unloaded.
+	 *  \retval false If no tree is hosted under the name.
+	 */
+    bool Unload(const string &name);
+
+	/*! Parks a tree, freeing its nodes but keeping its keys and text, so
+	 *  that it can be rebuilt without reading its file again. Pointers to
+	 *  the tree are no longer valid.
+	 *  \param name The name of the tree.
+	 *  \retval true If the tree is hosted, and is now parked.
+	 *  \retval false If no tree is hosted under the name.
+	 */
+    bool Park(const string &name);
+
+	/*! Returns the tree hosted under a name, rebuilding it first if it is
+	 *  parked.
+	 *  \param name The name of the tree.
+	 *  \retval tree A pointer to the tree, or NULL if it is not hosted.
+	 */
+    QATree* Find(const string &name);
+
+	/*! Returns the number of trees hosted by the forest, loaded or parked. */
+    size_t TreeCount() const;
+
+	/*! Returns the number of trees that are parked. */
+    size_t ParkedCount() const;
+
+	/*! Returns the number of nodes in use across every loaded tree. */
+    size_t NodesInUse() const;
+
+	/*! Returns the bytes held by the node pools of the loaded trees and by
+	 *  the shared block cache. Text longer than the string's inline capacity
+	 *  is allocated separately and is not included.
+	 */
+    size_t NodeBytes() const;
+
+	/*! Returns the bytes held for parked trees: their records, and the
+	 *  characters of the shared text table.
+	 */
+    size_t ParkedBytes() const;
+
+private:
+
+	/*! Forests own their trees and cannot be copied. */
+    QATreeForest(const QATreeForest& forest);
+    const QATreeForest& operator= (const QATreeForest& forest);
+
+	/*! Frees a tenant's loaded tree and releases its parked text.
+	 *  \param tenant The tenant to clear.
+	 */
+    void Clear(QATenant &tenant);
+
+	/*! Returns the shared copy of a text, adding a reference to it.
+	 *  \param text The text to share.
+	 */
+    const string* ShareText(const string &text);
+
+	/*! Drops a reference to a shared text, freeing it with the last one.
+	 *  \param text The shared text.
+	 */
+    void ReleaseText(const string *text);
+
+	/*! The blocks given up by unloaded trees. */
+    NodeBlockCache<string> blockCache;
+
+	/*! The hosted trees, by name. */
+    map<string, QATenant> tenants;
+
+	/*! Every text of the parked trees, with its number of references. */
+    map<string, int> sharedText;
+
+	/*! The number of characters held by the shared text. */
+    size_t sharedBytes;
+
+	/*! The number of records held by the parked trees. */
+    size_t parkedRecords;
+};
+
+#endif
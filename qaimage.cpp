@@ -0,0 +1,148 @@
+#include "qaimage.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+QAImage::QAImage()
+{
+    data = NULL;
+    size = 0;
+    nodes = NULL;
+    text = NULL;
+    nodeCount = 0;
+    textSize = 0;
+}
+
+QAImage::~QAImage()
+{
+    Close();
+}
+
+bool QAImage::Open(const string &fname)
+{
+    const QAImageHeader *header;
+
+    Close();
+
+#ifdef _WIN32
+    ifstream ifile(fname.c_str(), ios::binary);
+
+    if (!ifile)
+        return false;
+
+    buffer.assign(istreambuf_iterator<char>(ifile), istreambuf_iterator<char>());
+    ifile.close();
+
+    size = buffer.size();
+    data = buffer.empty() ? NULL : &buffer[0];
+#else
+    struct stat info;
+    void *mapped;
+    int fd = open(fname.c_str(), O_RDONLY);
+
+    if (fd < 0)
+        return false;
+
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    /* The mapping is shared, so every process reads the same page cache */
+    mapped = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapped == MAP_FAILED)
+        return false;
+
+    data = (const char *) mapped;
+    size = (size_t) info.st_size;
+#endif
+
+    header = (const QAImageHeader *) data;
+
+    if (   size < sizeof(QAImageHeader)
+        || memcmp(header->magic, "QAIM", 4) != 0
+        || header->version != IMAGE_VERSION
+        || header->nodeCount < 0 || header->textSize < 1
+        || (size - sizeof(QAImageHeader)) / sizeof(QAImageNode) < (size_t) header->nodeCount
+        || size - sizeof(QAImageHeader) - header->nodeCount * sizeof(QAImageNode)
+               < (size_t) header->textSize)
+    {
+        Close();
+        return false;
+    }
+
+    nodeCount = header->nodeCount;
+    textSize = header->textSize;
+    nodes = (const QAImageNode *) (data + sizeof(QAImageHeader));
+    text = data + sizeof(QAImageHeader) + nodeCount * sizeof(QAImageNode);
+
+    /* Every text ends with a terminator, so the last byte must be one */
+    if (text[textSize - 1] != '\0')
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void QAImage::Close()
+{
+#ifndef _WIN32
+    if (data != NULL)
+        munmap((void *) data, size);
+#endif
+
+    buffer.clear();
+    data = NULL;
+    size = 0;
+    nodes = NULL;
+    text = NULL;
+    nodeCount = 0;
+    textSize = 0;
+}
+
+int QAImage::NodeCount() const
+{
+    return nodeCount;
+}
+
+const char* QAImage::Text(int node) const
+{
+    if (node < 0 || node >= nodeCount
+     || nodes[node].textOffset < 0 || nodes[node].textOffset >= textSize)
+        return NULL;
+
+    return text + nodes[node].textOffset;
+}
+
+bool QAImage::IsAnswer(int node) const
+{
+    if (node < 0 || node >= nodeCount)
+        return false;
+
+    return (nodes[node].yesLink == IMAGE_NO_LINK && nodes[node].noLink == IMAGE_NO_LINK);
+}
+
+int QAImage::NextQA(int node, int qaPath) const
+{
+    int next;
+
+    if (node < 0 || node >= nodeCount)
+        return IMAGE_NO_LINK;
+
+    next = (qaPath != 0) ? nodes[node].yesLink : nodes[node].noLink;
+
+    return (next >= 0 && next < nodeCount) ? next : IMAGE_NO_LINK;
+}
@@ -0,0 +1,123 @@
+/*! \class QAImage
+ *  \brief A read-only question and answer tree mapped from an image file.
+ *
+ *  An image is a flat copy of a QATree written by QATree::WriteImage. Nodes
+ *  link to each other by index and hold their text by offset, so the file
+ *  can be mapped into memory and queried in place without being loaded.
+ *  Every process mapping the same image shares one copy of its pages.
+ *
+ *  \author agent
+ *  \version 1.0
+ *  \date 19-OCT-2026
+ *
+ * <pre>
+ *  Revision  Name        Date         Description
+ *  1         agent       19-OCT-2026  Created
+ * </pre>
+ */
+
+#ifndef _QAIMAGE_H
+#define	_QAIMAGE_H
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+using namespace std;
+
+const int IMAGE_VERSION = 1;            // The image layout written by WriteImage
+const int IMAGE_NO_LINK = -1;           // Marks a missing link in an image
+
+/*! \struct QAImageHeader
+ *  \brief The header at the start of an image file.
+ */
+struct QAImageHeader
+{
+    char magic[4];                      // Always "QAIM"
+    int version;                        // The image layout version
+    int nodeCount;                      // The number of nodes in the image
+    int textSize;                       // The number of bytes of text
+};
+
+/*! \struct QAImageNode
+ *  \brief A question or answer in an image file.
+ */
+struct QAImageNode
+{
+    int textOffset;                     // The offset of the node's text
+    int yesLink;                        // The index of the correct (right) child
+    int noLink;                         // The index of the incorrect (left) child
+};
+
+class QAImage
+{
+public:
+
+	/*! Default constructor for QAImage */
+    QAImage();
+
+	/*! Destructor for QAImage. Unmaps any open image. */
+    ~QAImage();
+
+	/*! Maps an image file read-only.
+	 *  \param fname The image file to map.
+	 *  \retval true If the file is mapped and is a valid image.
+	 *  \retval false If the file cannot be mapped or is not an image.
+	 */
+    bool Open(const string &fname);
+
+	/*! Unmaps the image, if one is open. */
+    void Close();
+
+	/*! Returns the number of nodes in the image. The root is node 0. */
+    int NodeCount() const;
+
+	/*! Returns the text of a node.
+	 *  \param node The index of the node.
+	 *  \retval text The question or answer text, or NULL if the node is invalid.
+	 */
+    const char* Text(int node) const;
+
+	/*! Returns true if a node is an answer.
+	 *  \param node The index of the node.
+	 *  \retval true If the node is valid and has no children.
+	 *  \retval false If the node is invalid or is a question.
+	 */
+    bool IsAnswer(int node) const;
+
+	/*! Returns the next question or answer.
+	 *  \param node The index of the current question.
+	 *  \param qaPath The path to follow (CORRECT_PATH or INCORRECT_PATH).
+	 *  \retval index The index of the next node, or IMAGE_NO_LINK if none.
+	 */
+    int NextQA(int node, int qaPath) const;
+
+private:
+
+	/*! Images own their mapping and cannot be copied. */
+    QAImage(const QAImage& image);
+    const QAImage& operator= (const QAImage& image);
+
+	/*! The start of the mapped file. */
+    const char *data;
+
+	/*! The size of the mapped file in bytes. */
+    size_t size;
+
+	/*! The node table within the mapped file. */
+    const QAImageNode *nodes;
+
+	/*! The text within the mapped file. */
+    const char *text;
+
+	/*! The number of nodes in the image. */
+    int nodeCount;
+
+	/*! The number of bytes of text in the image. */
+    int textSize;
+
+	/*! The file contents, on platforms without mmap. */
+    vector<char> buffer;
+};
+
+#endif
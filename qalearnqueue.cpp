@@ -0,0 +1,46 @@
+#include "qalearnqueue.h"
+
+QALearnQueue::QALearnQueue(QATree &qatree) : tree(qatree)
+{
+}
+
+void QALearnQueue::Submit(const QALearnRecord &record)
+{
+    lock_guard<mutex> guard(queueLock);
+
+    pending.push_back(record);
+}
+
+int QALearnQueue::Drain(vector<QALearnRecord> &conflicts)
+{
+    lock_guard<mutex> treeGuard(treeLock);
+    vector<QALearnRecord> batch;
+    vector<int> rejected;
+    int applied;
+
+    /* Take the whole queue at once, so workers can submit while it is applied */
+    {
+        lock_guard<mutex> queueGuard(queueLock);
+
+        batch.swap(pending);
+    }
+
+    conflicts.clear();
+
+    if (batch.empty())
+        return 0;
+
+    applied = tree.LearnBatch(batch, rejected);
+
+    for (size_t i = 0; i < rejected.size(); i++)
+        conflicts.push_back(batch[rejected[i]]);
+
+    return applied;
+}
+
+size_t QALearnQueue::Pending()
+{
+    lock_guard<mutex> guard(queueLock);
+
+    return pending.size();
+}
@@ -0,0 +1,80 @@
+/*! \class QALearnQueue
+ *  \brief Collects questions learned on many threads for one writer to apply.
+ *
+ *  Worker threads submit the questions their players teach, and never touch
+ *  the tree. A single writer drains the queue, applying everything queued
+ *  so far through QATree::LearnBatch: one walk of the tree and at most one
+ *  renumbering of its keys per drain, rather than a search and a possible
+ *  rescale for each question. Submitting only holds a lock while the record
+ *  is queued, so workers are not held up while a drain applies its batch.
+ *
+ *  The queue does not make learning scale with threads. Every learn is
+ *  still applied by the one writer; what the queue saves is the search per
+ *  learn, and the time workers would spend waiting on the tree. Per-leaf
+ *  locking is not possible while a learn may renumber every key, as both
+ *  LearnBatch and CreateQuestionAnswer do when keys are crowded.
+ *
+ *  \author agent
+ *  \version 2.0
+ *  \date 19-OCT-2026
+ *
+ * <pre>
+ *  Revision  Name        Date         Description
+ *  1         agent       19-OCT-2026  Created
+ *  2         agent       19-OCT-2026  States that the one writer limits
+ *                                     learning to one thread
+ * </pre>
+ */
+
+#ifndef _QALEARNQUEUE_H
+#define	_QALEARNQUEUE_H
+
+#include "qatree.h"
+#include <vector>
+#include <mutex>
+
+class QALearnQueue
+{
+public:
+
+	/*! Constructor for a queue that learns into a tree.
+	 *  \param qatree The tree to apply learned questions to. While the queue
+	 *                is in use, the tree must only be changed through Drain.
+	 */
+    QALearnQueue(QATree &qatree);
+
+	/*! Queues a learned question. Safe to call from any thread.
+	 *  \param record The question learned.
+	 */
+    void Submit(const QALearnRecord &record);
+
+	/*! Applies every question queued so far to the tree in one batch.
+	 *  Drains from several threads are applied one at a time.
+	 *  \retval conflicts The queued records that could not be applied.
+	 *  \retval count The number of records applied.
+	 */
+    int Drain(vector<QALearnRecord> &conflicts);
+
+	/*! Returns the number of questions waiting to be applied. */
+    size_t Pending();
+
+private:
+
+	/*! Queues are tied to their tree and cannot be copied. */
+    QALearnQueue(const QALearnQueue& queue);
+    const QALearnQueue& operator= (const QALearnQueue& queue);
+
+	/*! The tree being learned into. */
+    QATree &tree;
+
+	/*! The questions waiting to be applied. */
+    vector<QALearnRecord> pending;
+
+	/*! Guards the pending questions. */
+    mutex queueLock;
+
+	/*! Held while a batch is applied to the tree. */
+    mutex treeLock;
+};
+
+#endif
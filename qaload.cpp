@@ -0,0 +1,193 @@
+/*! \file qaload.cpp
+ *  \brief Load generator for qaserver.
+ *
+ * Connects a number of players to a running qaserver and, on one thread,
+ * answers Y to every prompt for a fixed time, so each player plays one
+ * winning round after another without teaching the tree. The time from
+ * sending each answer to receiving its reply is recorded, and the step
+ * rate and the median and 99th percentile step latencies are reported.
+ *
+ * Usage: qaload <socket path> [players] [seconds]
+ *
+ * Build (Linux only):
+ *   g++ -std=c++11 -O2 -o qaload qaload.cpp
+ *
+ * \author agent
+ * \date 19-OCT-2026
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+
+const int MAX_EVENTS = 256;             // Defines the events taken per epoll_wait
+const int READ_SIZE = 4096;             // Defines the read size used per player
+
+/*! One simulated player. */
+struct Player
+{
+	int fd;                             // The connected socket
+	string input;                       // Received bytes not yet consumed
+	bool answered;                      // True while an answer awaits its reply
+	chrono::steady_clock::time_point sent;  // When the last answer was sent
+};
+
+/*! Returns a socket connected to a path, or -1. */
+static int Connect(const string &path)
+{
+	struct sockaddr_un address;
+	int fd;
+
+	if (path.size() >= sizeof(address.sun_path))
+		return -1;
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path.c_str());
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	if (fd < 0)
+		return -1;
+
+	if (connect(fd, (struct sockaddr *) &address, sizeof(address)) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+/*! Sends the player's answer to the prompt just received.
+ *  \retval false If the answer could not be sent.
+ */
+static bool Answer(Player &player)
+{
+	player.sent = chrono::steady_clock::now();
+	player.answered = true;
+
+	/* Two bytes always fit in an empty socket buffer */
+	return write(player.fd, "y\n", 2) == 2;
+}
+
+int main(int argc, char** argv) {
+
+	vector<Player> players;
+	vector<double> latencies;			// Step latencies, in microseconds
+	struct epoll_event events[MAX_EVENTS];
+	struct epoll_event event;
+	char buffer[READ_SIZE];
+	chrono::steady_clock::time_point start;
+	chrono::steady_clock::time_point now;
+	double seconds;
+	size_t end;
+	int count;
+	int poller;
+	int ready;
+	int failures = 0;
+
+	if (argc < 2 || argc > 4) {
+		cout << "Usage: qaload <socket path> [players] [seconds]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	count = (argc > 2) ? atoi(argv[2]) : 100;
+	seconds = (argc > 3) ? atof(argv[3]) : 10;
+	poller = epoll_create1(EPOLL_CLOEXEC);
+
+	if (count < 1 || seconds <= 0 || poller < 0) {
+		cout << "Usage: qaload <socket path> [players] [seconds]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	players.resize(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		players[i].fd = Connect(argv[1]);
+		players[i].answered = false;
+
+		if (players[i].fd < 0) {
+			cout << "Error: Unable to connect player " << i + 1 << " to " << argv[1] << endl;
+			return (EXIT_FAILURE);
+		}
+
+		event.events = EPOLLIN;
+		event.data.u32 = i;
+		epoll_ctl(poller, EPOLL_CTL_ADD, players[i].fd, &event);
+	}
+
+	start = chrono::steady_clock::now();
+
+	while (chrono::duration<double>(chrono::steady_clock::now() - start).count() < seconds)
+	{
+		ready = epoll_wait(poller, events, MAX_EVENTS, 100);
+
+		for (int i = 0; i < ready; i++)
+		{
+			Player &player = players[events[i].data.u32];
+			ssize_t size = read(player.fd, buffer, sizeof(buffer));
+
+			if (size <= 0)
+			{
+				cout << "Error: Player disconnected" << endl;
+				return (EXIT_FAILURE);
+			}
+
+			player.input.append(buffer, size);
+
+			/* Each reply is one line; the first is the opening prompt */
+			while ((end = player.input.find('\n')) != string::npos)
+			{
+				now = chrono::steady_clock::now();
+
+				if (player.answered)
+					latencies.push_back(chrono::duration<double, micro>(now - player.sent).count());
+
+				if (player.input.compare(0, 6, "Error:") == 0)
+					failures++;
+
+				player.input.erase(0, end + 1);
+
+				if (!Answer(player))
+				{
+					cout << "Error: Unable to send to player" << endl;
+					return (EXIT_FAILURE);
+				}
+			}
+		}
+	}
+
+	seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	for (int i = 0; i < count; i++)
+		close(players[i].fd);
+
+	if (latencies.empty()) {
+		cout << "Error: No replies received" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	sort(latencies.begin(), latencies.end());
+
+	cout << "players:      " << count << endl
+		 << "steps:        " << latencies.size() << endl
+		 << "steps/s:      " << latencies.size() / seconds << endl
+		 << "p50 latency:  " << latencies[latencies.size() / 2] << " us" << endl
+		 << "p99 latency:  " << latencies[latencies.size() * 99 / 100] << " us" << endl
+		 << "errors:       " << failures << endl;
+
+	return (failures == 0) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+}
@@ -0,0 +1,146 @@
+#include "qaloader.h"
+#include <thread>
+#include <cerrno>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+QALoader::QALoader()
+{
+    failed = false;
+}
+
+bool QALoader::Load(QATree &tree, const string &fname)
+{
+    LoaderBlock *block;
+    string pending;
+    int fd;
+
+#ifdef _WIN32
+    fd = _open(fname.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    fd = open(fname.c_str(), O_RDONLY);
+#endif
+
+    if (fd < 0)
+        return false;
+
+#if !defined(_WIN32) && defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    failed = false;
+    filled.clear();
+    empty.clear();
+
+    for (int i = 0; i < LOADER_QUEUE_BLOCKS; i++)
+    {
+        blocks[i].data.resize(LOAD_BLOCK_SIZE);
+        empty.push_back(&blocks[i]);
+    }
+
+    thread reader(&QALoader::Read, this, fd);
+
+    /* Link each block while the reader fills the others */
+    while ((block = Pop(filled))->size != 0)
+    {
+        tree.LoadBlock(&block->data[0], &block->data[0] + block->size, pending);
+        Push(empty, block);
+    }
+
+    reader.join();
+
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+
+    if (!pending.empty())
+        tree.InsertRecord(pending.data(), pending.data() + pending.size());
+
+    return !failed;
+}
+
+void QALoader::Read(int fd)
+{
+    LoaderBlock *block;
+    long long offset = 0;
+    long count;
+
+    do
+    {
+        block = Pop(empty);
+        block->size = 0;
+
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+        /* Ask for the blocks beyond those already queued */
+        posix_fadvise(fd, offset, (off_t) LOAD_BLOCK_SIZE * LOADER_QUEUE_BLOCKS, POSIX_FADV_WILLNEED);
+#endif
+
+        /* Fill the whole block, so only the last one is short */
+        while (block->size < block->data.size())
+        {
+#ifdef _WIN32
+            count = _read(fd, &block->data[block->size], (unsigned int) (block->data.size() - block->size));
+#else
+            count = read(fd, &block->data[block->size], block->data.size() - block->size);
+#endif
+
+            if (count < 0 && errno == EINTR)
+                continue;
+
+            if (count < 0)
+            {
+                lock.lock();
+                failed = true;
+                lock.unlock();
+            }
+
+            if (count <= 0)
+                break;
+
+            block->size += count;
+        }
+
+        offset += block->size;
+
+        /* A short block is the last one; an empty block ends the load */
+        if (block->size != 0 && block->size < block->data.size())
+        {
+            Push(filled, block);
+            block = Pop(empty);
+            block->size = 0;
+        }
+
+        Push(filled, block);
+    }
+    while (block->size != 0);
+}
+
+QALoader::LoaderBlock* QALoader::Pop(deque<LoaderBlock*> &queue)
+{
+    unique_lock<mutex> guard(lock);
+    LoaderBlock *block;
+
+    while (queue.empty())
+        queued.wait(guard);
+
+    block = queue.front();
+    queue.pop_front();
+
+    return block;
+}
+
+void QALoader::Push(deque<LoaderBlock*> &queue, LoaderBlock *block)
+{
+    lock.lock();
+    queue.push_back(block);
+    lock.unlock();
+
+    queued.notify_all();
+}
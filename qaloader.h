@@ -0,0 +1,98 @@
+/*! \class QALoader
+ *  \brief Loads a tree file with reads overlapped with linking.
+ *
+ *  A reader thread reads the file in LOAD_BLOCK_SIZE blocks and passes
+ *  them through a bounded queue of LOADER_QUEUE_BLOCKS buffers to the
+ *  calling thread, which splits the records and links them into the tree
+ *  through the same code as QATree::LoadRecords. While one block is being
+ *  linked the next ones are already being read, so a load runs at the
+ *  speed of the slower of the disk and the linking rather than their sum.
+ *  The reader waits when every buffer is full, so memory use is bounded
+ *  however large the file is. On POSIX systems the file is opened with
+ *  sequential readahead advice, and the blocks ahead of the reader are
+ *  requested from the disk as it reaches them.
+ *
+ *  \author agent
+ *  \version 1.0
+ *  \date 19-OCT-2026
+ *
+ * <pre>
+ *  Revision  Name        Date         Description
+ *  1         agent       19-OCT-2026  Created
+ * </pre>
+ */
+
+#ifndef _QALOADER_H
+#define	_QALOADER_H
+
+#include "qatree.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+const int LOADER_QUEUE_BLOCKS = 4;      // Defines the blocks read ahead of linking
+
+class QALoader
+{
+public:
+
+	/*! Default constructor for QALoader */
+    QALoader();
+
+	/*! Loads every "key text" record from a file into a tree, as
+	 *  QATree::LoadRecords would.
+	 *  \param tree The tree to load the records into.
+	 *  \param fname The file to load.
+	 *  \retval true If the whole file was read.
+	 *  \retval false If the file could not be opened or read. Records read
+	 *                before the failure are kept in the tree.
+	 */
+    bool Load(QATree &tree, const string &fname);
+
+private:
+
+	/*! A buffer passed between the reader and the linking thread. */
+    struct LoaderBlock
+    {
+        vector<char> data;              // The bytes read
+        size_t size;                    // The bytes read into data; 0 at the end
+    };
+
+	/*! Loaders own their buffers and cannot be copied. */
+    QALoader(const QALoader& loader);
+    const QALoader& operator= (const QALoader& loader);
+
+	/*! Reads a file into empty blocks and queues them to be linked, ending
+	 *  with an empty block. Runs on the reader thread.
+	 *  \param fd The file descriptor to read.
+	 */
+    void Read(int fd);
+
+	/*! Takes the first block from a queue, waiting until one is queued. */
+    LoaderBlock* Pop(deque<LoaderBlock*> &queue);
+
+	/*! Adds a block to the end of a queue. */
+    void Push(deque<LoaderBlock*> &queue, LoaderBlock *block);
+
+	/*! The buffers. */
+    LoaderBlock blocks[LOADER_QUEUE_BLOCKS];
+
+	/*! Blocks read and waiting to be linked. */
+    deque<LoaderBlock*> filled;
+
+	/*! Blocks waiting to be read into. */
+    deque<LoaderBlock*> empty;
+
+	/*! Guards the queues and failed. */
+    mutex lock;
+
+	/*! Signalled whenever a block is queued. */
+    condition_variable queued;
+
+	/*! True if a read failed. */
+    bool failed;
+};
+
+#endif
@@ -0,0 +1,366 @@
+/*! \file qaserver.cpp
+ *  \brief Serves ObjectGuess to many players over a local Unix socket.
+ *
+ * Loads a decision tree file and plays any number of players against it
+ * at once, on one thread. Each connection is a C++20 coroutine that
+ * plays rounds through a QASession and suspends whenever it awaits the
+ * player's next line. An epoll event loop resumes whichever coroutine
+ * has a line ready. Every player shares the one tree, so what one player
+ * teaches is asked of the next.
+ *
+ * Protocol: the server sends the first prompt when a player connects,
+ * then exactly one line in reply to each line received. When a round is
+ * over, the reply ends with "Play again? (Y or N): ". Answering N closes
+ * the connection.
+ *
+ * On SIGINT or SIGTERM the server stops and saves the tree back to the
+ * tree file through QAFile.
+ *
+ * Usage: qaserver <tree file> <socket path>
+ *
+ * Build (Linux only):
+ *   g++ -std=c++20 -O2 -pthread -o qaserver qaserver.cpp qatree.cpp qasession.cpp \
+ *       qafile.cpp qaloader.cpp
+ *
+ * \author agent
+ * \date 19-OCT-2026
+ */
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <coroutine>
+#include <exception>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "qatree.h"
+#include "qasession.h"
+#include "qafile.h"
+#include "qaloader.h"
+
+using namespace std;
+
+const int MAX_EVENTS = 256;             // Defines the events taken per epoll_wait
+const int READ_SIZE = 4096;             // Defines the read size used per connection
+const size_t MAX_LINE = 4096;           // Defines the longest line a player may send
+
+static volatile sig_atomic_t stopping = 0;
+
+/*! A player's connection and the coroutine playing it. */
+struct Connection
+{
+	int fd;                             // The connected socket
+	string input;                       // Received bytes not yet consumed
+	string output;                      // Replies not yet written
+	bool closed;                        // True once the player has hung up
+	bool finished;                      // True once the coroutine has returned
+	coroutine_handle<> waiting;         // The coroutine awaiting a line, if any
+};
+
+/*! A coroutine that starts at once and frees itself when it returns. */
+struct Task
+{
+	struct promise_type
+	{
+		Task get_return_object() { return Task(); }
+		suspend_never initial_suspend() { return suspend_never(); }
+		suspend_never final_suspend() noexcept { return suspend_never(); }
+		void return_void() {}
+		void unhandled_exception() { terminate(); }
+	};
+};
+
+/*! Awaits the next line from a player. Resumes with false if the player
+ *  hangs up first. */
+struct LineAwaiter
+{
+	Connection &conn;
+	string &line;
+
+	bool await_ready() const
+	{
+		return conn.closed || conn.input.find('\n') != string::npos;
+	}
+
+	void await_suspend(coroutine_handle<> handle)
+	{
+		conn.waiting = handle;
+	}
+
+	bool await_resume()
+	{
+		size_t end = conn.input.find('\n');
+
+		if (end == string::npos)
+			return false;
+
+		line.assign(conn.input, 0, end);
+		conn.input.erase(0, end + 1);
+
+		if (!line.empty() && line[line.size() - 1] == '\r')
+			line.erase(line.size() - 1);
+
+		return true;
+	}
+};
+
+static LineAwaiter ReadLine(Connection &conn, string &line)
+{
+	return LineAwaiter{conn, line};
+}
+
+/*! Writes as much pending output as the socket accepts.
+ *  \retval false If the connection failed.
+ */
+static bool Flush(Connection &conn)
+{
+	ssize_t count;
+
+	while (!conn.output.empty())
+	{
+		count = write(conn.fd, conn.output.data(), conn.output.size());
+
+		if (count < 0 && errno == EINTR)
+			continue;
+
+		if (count < 0)
+			return (errno == EAGAIN || errno == EWOULDBLOCK);
+
+		conn.output.erase(0, count);
+	}
+
+	return true;
+}
+
+/*! Queues one reply line. Prompts may hold line breaks, which are sent as
+ *  spaces so that every reply is a single line. */
+static void Send(Connection &conn, string text)
+{
+	for (size_t i = 0; i < text.size(); i++)
+		if (text[i] == '\n')
+			text[i] = ' ';
+
+	conn.output += text;
+	conn.output += '\n';
+}
+
+/*! Plays rounds with one player until they decline another or hang up. */
+static Task Play(Connection &conn, QATree &tree)
+{
+	QASession session(tree);
+	string prompt;
+	string line;
+	bool playing = session.Start(prompt);
+
+	Send(conn, prompt);
+
+	while (playing && co_await ReadLine(conn, line))
+	{
+		if (session.GetState() != SESSION_FINISHED)
+		{
+			if (!session.Step(line, prompt))
+				prompt += (prompt.empty() ? "" : " ") + string("Play again? (Y or N): ");
+		}
+		else if (line == "y" || line == "Y")
+			playing = session.Start(prompt);
+		else if (line == "n" || line == "N")
+		{
+			prompt = "Goodbye.";
+			playing = false;
+		}
+		else
+			prompt = "INCORRECT RESPONSE - Please type Y or N Play again? (Y or N): ";
+
+		Send(conn, prompt);
+	}
+
+	conn.finished = true;
+}
+
+/*! Writes a connection's replies, and closes it once it is finished and
+ *  every reply is written. */
+static void Update(int poller, Connection *conn, map<int, Connection*> &connections)
+{
+	struct epoll_event event;
+
+	if (!Flush(*conn))
+		conn->closed = true;
+
+	if (conn->finished && (conn->output.empty() || conn->closed))
+	{
+		close(conn->fd);
+		connections.erase(conn->fd);
+		delete conn;
+		return;
+	}
+
+	/* Wait to write only while replies are pending */
+	event.events = EPOLLIN | EPOLLRDHUP | (conn->output.empty() ? 0u : (unsigned int) EPOLLOUT);
+	event.data.fd = conn->fd;
+	epoll_ctl(poller, EPOLL_CTL_MOD, conn->fd, &event);
+}
+
+static void Stop(int)
+{
+	stopping = 1;
+}
+
+/*! Returns a non-blocking socket listening on a path, or -1. */
+static int Listen(const string &path)
+{
+	struct sockaddr_un address;
+	int fd;
+
+	if (path.size() >= sizeof(address.sun_path))
+		return -1;
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path.c_str());
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	if (fd < 0)
+		return -1;
+
+	unlink(path.c_str());
+
+	if (   bind(fd, (struct sockaddr *) &address, sizeof(address)) != 0
+		|| listen(fd, SOMAXCONN) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+int main(int argc, char** argv) {
+
+	QATree qatree;						// The tree shared by every player
+	QALoader loader;
+	map<int, Connection*> connections;	// The connections, by socket
+	struct epoll_event events[MAX_EVENTS];
+	struct epoll_event event;
+	struct sigaction action;
+	char buffer[READ_SIZE];
+	int listener;
+	int poller;
+	int ready;
+
+	if (argc != 3) {
+		cout << "Usage: qaserver <tree file> <socket path>" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	if (!loader.Load(qatree, argv[1])) {
+		cout << "Error: Unable to read input file" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	if (qatree.IsEmpty()) {
+		cout << "Error: No root node defined. " << endl;
+		return (EXIT_FAILURE);
+	}
+
+	listener = Listen(argv[2]);
+	poller = epoll_create1(EPOLL_CLOEXEC);
+
+	if (listener < 0 || poller < 0) {
+		cout << "Error: Unable to listen on " << argv[2] << endl;
+		return (EXIT_FAILURE);
+	}
+
+	/* Signals interrupt epoll_wait rather than restarting it */
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = Stop;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	event.events = EPOLLIN;
+	event.data.fd = listener;
+	epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event);
+
+	while (!stopping)
+	{
+		ready = epoll_wait(poller, events, MAX_EVENTS, -1);
+
+		for (int i = 0; i < ready; i++)
+		{
+			int fd = events[i].data.fd;
+
+			if (fd == listener)
+			{
+				while ((fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+				{
+					Connection *conn = new Connection{fd, "", "", false, false, nullptr};
+
+					connections[fd] = conn;
+					event.events = EPOLLIN | EPOLLRDHUP;
+					event.data.fd = fd;
+					epoll_ctl(poller, EPOLL_CTL_ADD, fd, &event);
+
+					Play(*conn, qatree);
+					Update(poller, conn, connections);
+				}
+
+				continue;
+			}
+
+			Connection *conn = connections[fd];
+
+			if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+			{
+				ssize_t count;
+
+				while ((count = read(fd, buffer, sizeof(buffer))) > 0)
+					conn->input.append(buffer, count);
+
+				if (count == 0 || (count < 0 && errno != EAGAIN && errno != EINTR))
+					conn->closed = true;
+
+				/* A line too long to be an answer ends the connection */
+				if (conn->input.size() > MAX_LINE && conn->input.find('\n') == string::npos)
+					conn->closed = true;
+			}
+
+			if (conn->waiting && (conn->closed || conn->input.find('\n') != string::npos))
+			{
+				coroutine_handle<> handle = conn->waiting;
+
+				conn->waiting = nullptr;
+				handle.resume();
+			}
+
+			Update(poller, conn, connections);
+		}
+	}
+
+	/* Sessions awaiting a line are abandoned along with their connections */
+	for (map<int, Connection*>::iterator it = connections.begin(); it != connections.end(); ++it)
+	{
+		if (it->second->waiting)
+			it->second->waiting.destroy();
+
+		close(it->first);
+		delete it->second;
+	}
+
+	close(listener);
+	unlink(argv[2]);
+
+	if (!QAFile::SaveTree(qatree, argv[1])) {
+		cout << "Error: Unable to save file" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	return (EXIT_SUCCESS);
+}
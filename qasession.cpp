@@ -0,0 +1,98 @@
+#include "qasession.h"
+
+QASession::QASession(QATree &qatree) : tree(qatree)
+{
+    state = SESSION_FINISHED;
+    questionKey = 0;
+}
+
+bool QASession::Start(string &prompt)
+{
+    if (!tree.GetFirstQA(question, questionKey))
+    {
+        prompt = "Error: No root node defined. ";
+        state = SESSION_FINISHED;
+        return false;
+    }
+
+    state = SESSION_ASKING;
+    PromptQuestion(prompt);
+
+    return true;
+}
+
+bool QASession::Step(const string &input, string &prompt)
+{
+    string answer;
+
+    if (state == SESSION_ASKING)
+    {
+        if (   input != "n" && input != "N"
+            && input != "y" && input != "Y")
+        {
+            prompt = "INCORRECT RESPONSE - Please type Y or N\n";
+            PromptQuestion(answer);
+            prompt += answer;
+        }
+        /* If an answer was proposed, the round ends or learns */
+        else if (tree.IsAnswer(question, questionKey))
+        {
+            if (input == "y" || input == "Y")
+            {
+                prompt = "Notice the superior intellect of the computer!";
+                state = SESSION_FINISHED;
+            }
+            else
+            {
+                prompt = "What were you thinking of? ";
+                state = SESSION_OBJECT;
+            }
+        }
+        else
+        {
+            tree.GetNextQA(question, questionKey, answer,
+                           (input == "y" || input == "Y") ? CORRECT_PATH : INCORRECT_PATH);
+            question = answer;
+            PromptQuestion(prompt);
+        }
+    }
+    else if (state == SESSION_OBJECT)
+    {
+        if (input.empty())
+            prompt = "What were you thinking of? ";
+        else
+        {
+            newAnswer = input;
+            prompt = "Please specify a question that has a yes answer for your "
+                     "object and a no answer for my guess: ";
+            state = SESSION_QUESTION;
+        }
+    }
+    else if (state == SESSION_QUESTION)
+    {
+        /* Another session sharing the tree may have replaced the guess meanwhile */
+        if (tree.CreateQuestionAnswer(input, newAnswer, question))
+            prompt.clear();
+        else
+            prompt = "Error: Unable to learn \"" + newAnswer + "\".";
+
+        state = SESSION_FINISHED;
+    }
+    else
+        prompt.clear();
+
+    return (state != SESSION_FINISHED);
+}
+
+int QASession::GetState() const
+{
+    return state;
+}
+
+void QASession::PromptQuestion(string &prompt)
+{
+    if (tree.IsAnswer(question, questionKey))
+        prompt = "I guess that your object is a(n) " + question + "? (Y or N): ";
+    else
+        prompt = question + " ";
+}
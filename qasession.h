@@ -0,0 +1,87 @@
+/*! \class QASession
+ *  \brief Plays one round of ObjectGuess one line of input at a time.
+ *
+ *  A session holds the state that main.cpp keeps on its stack between
+ *  blocking reads: the current question and any object being learned.
+ *  Each call to Step consumes one line from the player and returns the
+ *  next prompt, so a caller can drive many sessions without blocking on
+ *  any one of them.
+ *
+ *  \author agent
+ *  \version 3.0
+ *  \date 19-OCT-2026
+ *
+ * <pre>
+ *  Revision  Name        Date         Description
+ *  1         agent       19-OCT-2026  Created
+ *  2         agent       19-OCT-2026  Step reports questions it could not learn
+ *  3         agent       19-OCT-2026  Questions are followed by key
+ * </pre>
+ */
+
+#ifndef _QASESSION_H
+#define	_QASESSION_H
+
+#include "qatree.h"
+#include <string>
+
+const int SESSION_ASKING = 0;           // Awaiting a yes/no answer
+const int SESSION_OBJECT = 1;           // Awaiting the player's object
+const int SESSION_QUESTION = 2;         // Awaiting a distinguishing question
+const int SESSION_FINISHED = 3;         // The round is over
+
+class QASession
+{
+public:
+
+	/*! Constructor for a session played against a tree.
+	 *  \param qatree The tree to question the player with and learn into.
+	 */
+    QASession(QATree &qatree);
+
+	/*! Starts a new round.
+	 *  \retval prompt The first question for the player.
+	 *  \retval true If the round has started.
+	 *  \retval false If the tree has no root node.
+	 */
+    bool Start(string &prompt);
+
+	/*! Consumes one line of player input and advances the round.
+	 *  \param input The player's line of input.
+	 *  \retval prompt The next prompt for the player, or the closing message
+	 *                  of the round. It holds an error if the new question
+	 *                  could not be learned.
+	 *  \retval true If the round continues and awaits more input.
+	 *  \retval false If the round is over.
+	 */
+    bool Step(const string &input, string &prompt);
+
+	/*! Returns the current state of the session (SESSION_ASKING,
+	 *  SESSION_OBJECT, SESSION_QUESTION or SESSION_FINISHED).
+	 */
+    int GetState() const;
+
+private:
+
+	/*! Builds the prompt for the current question or guess.
+	 *  \retval prompt The prompt for the player.
+	 */
+    void PromptQuestion(string &prompt);
+
+	/*! The tree being played. */
+    QATree &tree;
+
+	/*! The current state of the session. */
+    int state;
+
+	/*! The current question or guessed answer. */
+    string question;
+
+	/*! The key of the current question or guessed answer. */
+    int questionKey;
+
+	/*! The player's object, while a new question is being learned. */
+    string newAnswer;
+};
+
+#endif
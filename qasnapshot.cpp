@@ -0,0 +1,97 @@
+#include "qasnapshot.h"
+#include "qafile.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+QASnapshot::QASnapshot() : running(false)
+{
+    copy = NULL;
+    saved = false;
+#ifndef _WIN32
+    child = -1;
+#endif
+}
+
+QASnapshot::~QASnapshot()
+{
+    Wait();
+}
+
+bool QASnapshot::Begin(QATree &tree, const string &fname)
+{
+    if (running)
+        return false;
+
+    /* A finished save may not have been waited for yet */
+    if (worker.joinable())
+        worker.join();
+
+    fileName = fname;
+    saved = false;
+
+#ifndef _WIN32
+    /* The child sees the tree as it is now; later changes copy only the pages they touch */
+    child = fork();
+
+    if (child == 0)
+        _exit(QAFile::SaveTree(tree, fname) ? 0 : 1);
+#endif
+
+    /* Without fork, or if it failed, the tree is copied on this thread */
+    if (!Forked())
+    {
+        copy = new QATree;
+        *copy = tree;
+    }
+
+    running = true;
+    worker = thread(&QASnapshot::Run, this);
+
+    return true;
+}
+
+bool QASnapshot::Wait()
+{
+    if (worker.joinable())
+        worker.join();
+
+    return saved;
+}
+
+bool QASnapshot::Forked() const
+{
+#ifdef _WIN32
+    return false;
+#else
+    return child > 0;
+#endif
+}
+
+void QASnapshot::Run()
+{
+#ifndef _WIN32
+    int status = 0;
+    pid_t waited;
+
+    if (Forked())
+    {
+        while ((waited = waitpid(child, &status, 0)) < 0 && errno == EINTR)
+            continue;
+
+        saved = (waited == child && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        child = -1;
+        running = false;
+        return;
+    }
+#endif
+
+    saved = QAFile::SaveTree(*copy, fileName);
+
+    delete copy;
+    copy = NULL;
+    running = false;
+}
@@ -0,0 +1,105 @@
+/*! \class QASnapshot
+ *  \brief Saves a point-in-time view of a QATree in the background.
+ *
+ *  On POSIX systems Begin forks, and the child process saves the tree as it
+ *  was at the fork and exits, while a worker thread waits for it. The fork
+ *  copies no nodes: parent and child share the tree's pages, and each page
+ *  the live tree changes afterwards is copied once, by the kernel. Begin
+ *  therefore costs the same whatever the size of the tree, apart from the
+ *  page tables that fork duplicates.
+ *
+ *  Where fork is not available (Windows), or if it fails, Begin copies the
+ *  tree on the calling thread, which costs one pass over memory, and the
+ *  worker thread saves the copy and then frees it.
+ *
+ *  The live tree may be played and learned into as soon as Begin returns.
+ *  The file is saved through QAFile, so readers never see a partially
+ *  written tree. A forked child holds only the thread that called Begin,
+ *  so no other thread may be changing the tree, or hold a lock the save
+ *  needs, during the call.
+ *
+ *  \author agent
+ *  \version 3.0
+ *  \date 19-OCT-2026
+ *
+ * <pre>
+ *  Revision  Name        Date         Description
+ *  1         agent       19-OCT-2026  Created
+ *  2         agent       19-OCT-2026  Saves through QAFile. The copy is freed
+ *                                     after each save.
+ *  3         agent       19-OCT-2026  Saves from a forked child on POSIX
+ *                                     systems rather than from a copy
+ * </pre>
+ */
+
+#ifndef _QASNAPSHOT_H
+#define	_QASNAPSHOT_H
+
+#include "qatree.h"
+#include <string>
+#include <thread>
+#include <atomic>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+class QASnapshot
+{
+public:
+
+	/*! Default constructor for QASnapshot */
+    QASnapshot();
+
+	/*! Destructor for QASnapshot. Waits for any save in progress. */
+    ~QASnapshot();
+
+	/*! Starts saving a point-in-time view of a tree in the background.
+	 *  \param tree The tree to save. It must not change during the call.
+	 *  \param fname The file to save the tree to.
+	 *  \retval true If the save has started.
+	 *  \retval false If a save is still in progress.
+	 */
+    bool Begin(QATree &tree, const string &fname);
+
+	/*! Waits for the save in progress, if any, to finish.
+	 *  \retval true If the last save completed successfully.
+	 *  \retval false If the last save failed, or no save was started.
+	 */
+    bool Wait();
+
+private:
+
+	/*! Snapshots own their worker thread and cannot be copied. */
+    QASnapshot(const QASnapshot& snapshot);
+    const QASnapshot& operator= (const QASnapshot& snapshot);
+
+	/*! Waits for the child saving the tree, or saves the copied tree. Runs
+	 *  on the worker thread. */
+    void Run();
+
+	/*! Returns true if the save in progress is being made by a child. */
+    bool Forked() const;
+
+	/*! The point-in-time copy being saved, or NULL if there is none. */
+    QATree *copy;
+
+#ifndef _WIN32
+	/*! The child process saving the tree, or -1 if there is none. */
+    pid_t child;
+#endif
+
+	/*! The file being saved to. */
+    string fileName;
+
+	/*! The thread saving the copy, or waiting for the child. */
+    thread worker;
+
+	/*! True while the worker thread is saving. */
+    atomic<bool> running;
+
+	/*! True if the last save completed successfully. */
+    bool saved;
+};
+
+#endif
@@ -1,13 +1,25 @@
 #include "qatree.h"
-
-bool QATree::IsAnswer(string qaText)
+#include "compiledtree.h"
+#include "qaimage.h"
+#include <cctype>
+#include <cstring>
+#include <climits>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+bool QATree::IsAnswer(const string &qaText)
 {
-    int key = 0;
+    StringNode *node = FindNode(root, qaText);
     bool isAnswer = false;
 
-    if (Search(qaText, key))
+    if (node != NULL)
     {
-        if (IsLeaf(key))
+        if (node->lLink == NULL && node->rLink == NULL)
         {
             isAnswer = true;
         }
@@ -16,9 +28,109 @@ bool QATree::IsAnswer(string qaText)
     return isAnswer;
 }
 
+bool QATree::IsAnswer(const string &qaText, int key) const
+{
+    StringNode *node = LocateNode(qaText, key);
+
+    return (node != NULL && node->lLink == NULL && node->rLink == NULL);
+}
+
+StringNode* QATree::LocateNode(const string &qaText, int key) const
+{
+    StringNode *node = FindKey(key);
+
+    if (node == NULL || node->info != qaText)
+        node = FindNode(root, qaText);
+
+    return node;
+}
+
+int QATree::ClassifyBatch(const vector<string> &answerSets, vector<string> &answers) const
+{
+    vector<const StringNode*> leaves(answerSets.size());
+    int classified = 0;
+
+    if (!answerSets.empty())
+        classified = ClassifyBatch(answerSets, 0, answerSets.size(), &leaves[0]);
+
+    answers.assign(answerSets.size(), string());
+
+    for (size_t i = 0; i < leaves.size(); i++)
+        if (leaves[i] != NULL)
+            answers[i] = leaves[i]->info;
+
+    return classified;
+}
+
+int QATree::ClassifyBatch(const vector<string> &answerSets, size_t begin, size_t end,
+                          const StringNode **leaves) const
+{
+    const StringNode *current[CLASSIFY_GROUP_SIZE];
+    size_t group;
+    size_t count;
+    size_t depth;
+    size_t i;
+    int active;
+    int classified = 0;
+    char input;
+
+    if (end > answerSets.size())
+        end = answerSets.size();
+
+    for (group = begin; group < end; group += CLASSIFY_GROUP_SIZE)
+    {
+        count = end - group;
+
+        if (count > (size_t) CLASSIFY_GROUP_SIZE)
+            count = CLASSIFY_GROUP_SIZE;
+
+        for (i = 0; i < count; i++)
+        {
+            current[i] = root;
+            leaves[group + i] = NULL;
+        }
+
+        /* Advance every walk in the group by one question per pass */
+        for (depth = 0, active = (int) count; active > 0; depth++)
+        {
+            active = 0;
+
+            for (i = 0; i < count; i++)
+            {
+                if (current[i] == NULL)
+                    continue;
+
+                if (current[i]->lLink == NULL && current[i]->rLink == NULL)
+                {
+                    leaves[group + i] = current[i];
+                    classified++;
+                    current[i] = NULL;
+                    continue;
+                }
+
+                input = (depth < answerSets[group + i].size())
+                      ? answerSets[group + i][depth] : '\0';
+
+                if (input == 'y' || input == 'Y')
+                    current[i] = current[i]->rLink;
+                else if (input == 'n' || input == 'N')
+                    current[i] = current[i]->lLink;
+                else
+                    current[i] = NULL;
+
+                if (current[i] != NULL)
+                    active++;
+            }
+        }
+    }
+
+    return classified;
+}
+
 bool QATree::CreateQuestionAnswer(string newQuestion, string newAnswer,
                                   string alternativeQA)
 {
+    StringNode *previous = NULL;
     int key = 0;
     bool created = false;
 
@@ -32,11 +144,9 @@ bool QATree::CreateQuestionAnswer(string newQuestion, string newAnswer,
     }
     else
     {
-        if (ScalingRequired(root))
-        {
-            nodeScale++;
-            ScaleNodes(root, nodeScale);
-        }
+        /* Scaling multiplies every key by each new scale in turn, and overflows after a dozen */
+        if (KeysCrowded(root, previous))
+            NumberKeys(root, -(nodeCount - 1));
 
         /* Search for the alternate answer. Store off the key if it is found */
         if (Search(alternativeQA, key))
@@ -64,24 +174,327 @@ bool QATree::CreateQuestionAnswer(string newQuestion, string newAnswer,
     return created;
 }
 
-bool QATree::GetNextQA(string question, string &answer, int qaPath){
+int QATree::LearnBatch(const vector<QALearnRecord> &records, vector<int> &conflicts)
+{
+    map<string, StringNode*> nodes;
+    map<string, StringNode*>::iterator found;
+    set<string> targets;
+    set<StringNode*> learned;
+    StringNode *previous = NULL;
+    StringNode *node;
+    size_t i = 0;
+    int applied = 0;
+
+    conflicts.clear();
+
+    /* An empty tree is seeded by the first record */
+    if (root == NULL && !records.empty())
+    {
+        CreateQuestionAnswer(records[0].question, records[0].answer,
+                             records[0].alternateQA);
+        learned.insert(root);
+        applied++;
+        i++;
+    }
+
+    for (size_t j = i; j < records.size(); j++)
+        targets.insert(records[j].alternateQA);
+
+    MapNodes(root, targets, nodes);
+
+    /* Renumbering keeps keys within the tree's size, where scaling multiplies them every batch */
+    if (i < records.size() && KeysCrowded(root, previous))
+        NumberKeys(root, -(nodeCount - 1));
+
+    for (; i < records.size(); i++)
+    {
+        found = nodes.find(records[i].alternateQA);
+
+        if (found == nodes.end())
+        {
+            cout << "Error: Unable to find answer: \"" << records[i].alternateQA << "\"." << endl;
+            conflicts.push_back((int) i);
+            continue;
+        }
+
+        node = found->second;
+
+        if (learned.count(node) != 0)
+        {
+            cout << "Error: \"" << records[i].alternateQA << "\" was already replaced in this batch." << endl;
+            conflicts.push_back((int) i);
+            continue;
+        }
+
+        if (node->lLink != NULL || node->rLink != NULL)
+        {
+            cout << "Error: \"" << records[i].alternateQA << "\" is a question." << endl;
+            conflicts.push_back((int) i);
+            continue;
+        }
+
+        /* Keys are at least 2 apart, so key - 1 and key + 1 fall below the guess */
+        node->info = records[i].question;
+
+        node->rLink = nodePool->Allocate();
+        node->rLink->info = records[i].answer;
+        node->rLink->key = node->key + 1;
+
+        node->lLink = nodePool->Allocate();
+        node->lLink->info = records[i].alternateQA;
+        node->lLink->key = node->key - 1;
+
+        nodeCount += 2;
+        learned.insert(node);
+        applied++;
+    }
+
+    return applied;
+}
+
+void QATree::MapNodes(StringNode *node, const set<string> &targets,
+                      map<string, StringNode*> &nodes) const
+{
+    vector<StringNode*> pending;
+
+    if (node != NULL)
+        pending.push_back(node);
+
+    while (!pending.empty() && nodes.size() < targets.size())
+    {
+        node = pending.back();
+        pending.pop_back();
+
+        /* The first node found in preorder keeps the text */
+        if (targets.count(node->info) != 0)
+            nodes.insert(make_pair(node->info, node));
+
+        if (node->rLink != NULL)
+            pending.push_back(node->rLink);
+
+        if (node->lLink != NULL)
+            pending.push_back(node->lLink);
+    }
+}
+
+bool QATree::KeysCrowded(StringNode *node, StringNode* &previous) const
+{
+    bool crowded = false;
+
+    if (node != NULL)
+    {
+        crowded = KeysCrowded(node->lLink, previous);
+
+        if (!crowded && previous != NULL && (node->key - previous->key) < 2)
+            crowded = true;
+
+        previous = node;
+
+        if (!crowded)
+            crowded = KeysCrowded(node->rLink, previous);
+    }
+
+    return crowded;
+}
+
+bool QATree::Merge(const QATree &base, const QATree &first, const QATree &second,
+                   vector<string> &conflicts)
+{
+    StringNode *merged;
+
+    conflicts.clear();
+
+    /* Build the merge before destroying this tree, which may be an input */
+    merged = MergeNodes(base.root, first.root, second.root, conflicts);
+
+    Destroy(root);
+    root = merged;
+    nodeCount = CountNodes(root);
+
+    if (root != NULL)
+        NumberKeys(root, -(nodeCount - 1));
+
+    return conflicts.empty();
+}
+
+StringNode* QATree::MergeNodes(StringNode *base, StringNode *first, StringNode *second,
+                               vector<string> &conflicts)
+{
+    StringNode *node = NULL;
+    bool firstLearned;
+    bool secondLearned;
+
+    if (base == NULL)
+    {
+        /* Both sides grew from an empty tree, so only their common part can be trusted */
+        if (first != NULL && second != NULL)
+            return MergeCommon(first, second, conflicts);
+
+        CopyTree(node, (first != NULL) ? first : second);
+        return node;
+    }
+
+    if (first == NULL || second == NULL)
+    {
+        /* Learning never removes nodes, so one side is not from this base */
+        conflicts.push_back(base->info);
+        CopyTree(node, (first != NULL) ? first : second);
+        return node;
+    }
+
+    if (base->lLink != NULL || base->rLink != NULL)
+    {
+        /* Learning never changes a question, so both sides must still match it */
+        if (   first->info != base->info || second->info != base->info
+            || first->lLink == NULL || first->rLink == NULL
+            || second->lLink == NULL || second->rLink == NULL)
+        {
+            conflicts.push_back(base->info);
+            CopyTree(node, first);
+            return node;
+        }
+
+        node = nodePool->Allocate();
+        node->info = base->info;
+        node->lLink = MergeNodes(base->lLink, first->lLink, second->lLink, conflicts);
+        node->rLink = MergeNodes(base->rLink, first->rLink, second->rLink, conflicts);
+
+        return node;
+    }
+
+    firstLearned = (first->lLink != NULL || first->rLink != NULL || first->info != base->info);
+    secondLearned = (second->lLink != NULL || second->rLink != NULL || second->info != base->info);
+
+    if (firstLearned && secondLearned)
+        return MergeCommon(first, second, conflicts);
+
+    CopyTree(node, (!firstLearned && secondLearned) ? second : first);
+
+    return node;
+}
+
+StringNode* QATree::MergeCommon(StringNode *first, StringNode *second,
+                                vector<string> &conflicts)
+{
+    StringNode *node = NULL;
+    bool firstLeaf = (first->lLink == NULL && first->rLink == NULL);
+    bool secondLeaf = (second->lLink == NULL && second->rLink == NULL);
+
+    /* Identical subtrees need no scan first: they merge below into a copy */
+    if (firstLeaf && secondLeaf && first->info == second->info)
+    {
+        CopyTree(node, first);
+    }
+    else if (!firstLeaf && !secondLeaf && first->info == second->info
+          && first->lLink != NULL && first->rLink != NULL
+          && second->lLink != NULL && second->rLink != NULL)
+    {
+        /* Both sides learned the same question, so merge what each learned below it */
+        node = nodePool->Allocate();
+        node->info = first->info;
+        node->lLink = MergeCommon(first->lLink, second->lLink, conflicts);
+        node->rLink = MergeCommon(first->rLink, second->rLink, conflicts);
+    }
+    else if (firstLeaf != secondLeaf)
+    {
+        /* The leaf is the common part, and the other side learned below it */
+        CopyTree(node, firstLeaf ? second : first);
+    }
+    else
+    {
+        conflicts.push_back(first->info);
+        CopyTree(node, first);
+    }
+
+    return node;
+}
+
+int QATree::NumberKeys(StringNode *node, int key)
+{
+    if (node != NULL)
+    {
+        key = NumberKeys(node->lLink, key);
+        node->key = key;
+        key = NumberKeys(node->rLink, key + 2);
+    }
+
+    return key;
+}
+
+bool QATree::ExplainPath(const string &answer, vector<string> &questions,
+                         vector<int> &qaPaths) const
+{
+    StringNode *node = FindNode(root, answer);
+    StringNode *current = root;
+
+    questions.clear();
+    qaPaths.clear();
 
-    int parentKey;
-    int siblingKey;
+    if (node == NULL || node->lLink != NULL || node->rLink != NULL)
+        return false;
 
-    if (Search(question, parentKey))
+    /* Walk down by key, as Navigate does, recording each question passed */
+    while (current != node)
     {
-        if (!IsLeaf(parentKey)){
+        questions.push_back(current->info);
+
+        if (current->key < node->key)
+        {
+            qaPaths.push_back(CORRECT_PATH);
+            current = current->rLink;
+        }
+        else
+        {
+            qaPaths.push_back(INCORRECT_PATH);
+            current = current->lLink;
+        }
+    }
+
+    return true;
+}
+
+bool QATree::GetNextQA(const string &question, string &answer, int qaPath){
+
+    StringNode *next;
+
+    return FollowQA(FindNode(root, question), answer, next, qaPath);
+}
+
+bool QATree::GetNextQA(const string &question, int &key, string &answer, int qaPath){
+
+    StringNode *next = NULL;
+    bool found = FollowQA(LocateNode(question, key), answer, next, qaPath);
+
+    if (next != NULL)
+        key = next->key;
+
+    return found;
+}
+
+bool QATree::FollowQA(StringNode *parent, string &answer, StringNode* &next, int qaPath){
+
+    next = NULL;
+
+    /* Follow the links of the question found, rather than searching again by key */
+    if (parent != NULL)
+    {
+        if (parent->lLink != NULL || parent->rLink != NULL){
             if (qaPath == CORRECT_PATH)
-                Navigate(parentKey, answer, siblingKey, RIGHT_LINK);
+                next = parent->rLink;
             else if (qaPath == INCORRECT_PATH)
-                Navigate(parentKey, answer, siblingKey, LEFT_LINK);
+                next = parent->lLink;
             else
             {
                 cout << "Error: Incorrect question/ answer path defined";
                 return false;
             }
 
+            if (next != NULL)
+            {
+                answer = next->info;
+                CountVisit(next);
+            }
+
             return true;
         }
     }
@@ -89,6 +502,15 @@ bool QATree::GetNextQA(string question, string &answer, int qaPath){
     return false;
 }
 
+bool QATree::GetFirstQA(string &question, int &key){
+
+    if (!GetFirstQA(question))
+        return false;
+
+    key = root->key;
+    return true;
+}
+
 bool QATree::GetFirstQA(string &question){
 
     bool found = false;
@@ -97,6 +519,7 @@ bool QATree::GetFirstQA(string &question){
     {
         question = root->info;
         found = true;
+        CountVisit(root);
     }
 
     return found;
@@ -107,10 +530,194 @@ QATree::QATree()
     nodeScale = DEFAULT_SCALE;
 }
 
+QATree::QATree(NodePool<string> *pool) : StringBST(pool)
+{
+    nodeScale = DEFAULT_SCALE;
+}
+
 QATree::~QATree()
 {
 }
 
+void QATree::LoadRecords(istream &input)
+{
+    vector<char> block(LOAD_BLOCK_SIZE);
+    string pending;
+
+    while (input)
+    {
+        input.read(&block[0], block.size());
+        LoadBlock(&block[0], &block[0] + input.gcount(), pending);
+    }
+
+    if (!pending.empty())
+        InsertRecord(pending.data(), pending.data() + pending.size());
+}
+
+void QATree::LoadBlock(const char *first, const char *last, string &pending)
+{
+    const char *newline;
+
+    while ((newline = (const char *) memchr(first, '\n', last - first)) != NULL)
+    {
+        /* Records split across two blocks are stitched together first */
+        if (pending.empty())
+            InsertRecord(first, newline);
+        else
+        {
+            pending.append(first, newline);
+            InsertRecord(pending.data(), pending.data() + pending.size());
+            pending.clear();
+        }
+
+        first = newline + 1;
+    }
+
+    pending.append(first, last);
+}
+
+void QATree::InsertRecord(const char *first, const char *last)
+{
+    unsigned int key = 0;
+    unsigned int limit;
+    unsigned int digit;
+    bool negative = false;
+
+    while (first != last && isspace((unsigned char) *first))
+        first++;
+
+    if (first != last && (*first == '-' || *first == '+'))
+    {
+        negative = (*first == '-');
+        first++;
+    }
+
+    if (first == last || !isdigit((unsigned char) *first))
+        return;
+
+    /* A negative key may reach one further than a positive key */
+    limit = negative ? (unsigned int) INT_MAX + 1u : (unsigned int) INT_MAX;
+
+    while (first != last && isdigit((unsigned char) *first))
+    {
+        digit = (unsigned int) (*first++ - '0');
+
+        if (key > (limit - digit) / 10)
+        {
+            cout << "Error: Key out of range. Record not inserted." << endl;
+            return;
+        }
+
+        key = (key * 10) + digit;
+    }
+
+    /* Trim the spaces surrounding the question or answer text */
+    while (first != last && *first == ' ')
+        first++;
+
+    while (last != first && *(last - 1) == ' ')
+        last--;
+
+    Insert(string(first, last), negative ? -(int) (key - 1u) - 1 : (int) key);
+}
+
+void QATree::WriteCompiledTable(ostream &output, const string &name) const
+{
+    vector<const StringNode*> nodes;
+    map<const StringNode*, int> index;
+    size_t i;
+    size_t c;
+
+    NumberNodes(root, nodes, index);
+
+    output << "/* Generated by qacompile. Do not edit. */" << '\n'
+           << '\n'
+           << "#include \"compiledtree.h\"" << '\n'
+           << '\n'
+           << "static const int " << name << "Size = " << nodes.size() << ";" << '\n'
+           << '\n'
+           << "static const CompiledQANode " << name << "[] =" << '\n'
+           << "{" << '\n';
+
+    for (i = 0; i < nodes.size(); i++)
+    {
+        output << "    { \"";
+
+        /* Escape the text so that it forms a valid string literal. Control
+           characters are written as octal, and '?' is escaped so that no
+           trigraph can form on compilers that still translate them. */
+        for (c = 0; c < nodes[i]->info.size(); c++)
+        {
+            unsigned char ch = (unsigned char) nodes[i]->info[c];
+
+            if (ch == '"' || ch == '\\' || ch == '?')
+                output << '\\' << (char) ch;
+            else if (ch < 0x20 || ch == 0x7f)
+                output << '\\' << (char) ('0' + (ch >> 6))
+                       << (char) ('0' + ((ch >> 3) & 7)) << (char) ('0' + (ch & 7));
+            else
+                output << (char) ch;
+        }
+
+        output << "\", "
+               << ((nodes[i]->rLink != NULL) ? index[nodes[i]->rLink] : COMPILED_NO_LINK) << ", "
+               << ((nodes[i]->lLink != NULL) ? index[nodes[i]->lLink] : COMPILED_NO_LINK) << " }"
+               << ((i + 1 < nodes.size()) ? "," : "") << '\n';
+    }
+
+    output << "};" << '\n';
+}
+
+void QATree::WriteImage(ostream &output) const
+{
+    vector<const StringNode*> nodes;
+    map<const StringNode*, int> index;
+    vector<QAImageNode> table;
+    QAImageHeader header;
+    int textSize = 0;
+    size_t i;
+
+    NumberNodes(root, nodes, index);
+
+    table.resize(nodes.size());
+
+    for (i = 0; i < nodes.size(); i++)
+    {
+        table[i].textOffset = textSize;
+        table[i].yesLink = (nodes[i]->rLink != NULL) ? index[nodes[i]->rLink] : IMAGE_NO_LINK;
+        table[i].noLink = (nodes[i]->lLink != NULL) ? index[nodes[i]->lLink] : IMAGE_NO_LINK;
+
+        textSize += (int) nodes[i]->info.size() + 1;
+    }
+
+    memcpy(header.magic, "QAIM", 4);
+    header.version = IMAGE_VERSION;
+    header.nodeCount = (int) nodes.size();
+    header.textSize = textSize;
+
+    output.write((const char *) &header, sizeof(header));
+
+    if (!table.empty())
+        output.write((const char *) &table[0], table.size() * sizeof(QAImageNode));
+
+    /* Text is written with terminators so it can be read in place */
+    for (i = 0; i < nodes.size(); i++)
+        output.write(nodes[i]->info.c_str(), nodes[i]->info.size() + 1);
+}
+
+void QATree::NumberNodes(const StringNode *node, vector<const StringNode*> &nodes,
+                         map<const StringNode*, int> &index) const
+{
+    if (node != NULL)
+    {
+        index[node] = (int) nodes.size();
+        nodes.push_back(node);
+
+        NumberNodes(node->lLink, nodes, index);
+        NumberNodes(node->rLink, nodes, index);
+    }
+}
+
 istream & operator >>( istream & input, QATree & QA)
 {
     int key;
@@ -136,27 +743,96 @@ istream & operator >>( istream & input, QATree & QA)
     return input;
 }
 
-ostream & operator <<(ostream & output, QATree & QA)
+void QATree::FormatRecords(vector<const StringNode*> &pending, string &buffer) const
 {
-    StringNode* currentNode = QA.root;
-    queue< StringNode* > q;
+    const StringNode *node;
+    char digits[16];
+    char *p;
+    unsigned int value;
 
-    q.push(currentNode);
+    while (!pending.empty() && buffer.size() < (size_t) SAVE_BLOCK_SIZE)
+    {
+        node = pending.back();
+        pending.pop_back();
 
-    while (!q.empty()) {
+        /* Format the key by hand, avoiding stream formatting per node */
+        value = (node->key < 0) ? 0u - (unsigned int) node->key : (unsigned int) node->key;
+        p = digits + sizeof(digits);
 
-        currentNode = q.front();
-        q.pop();
+        do {
+            *--p = (char) ('0' + (value % 10));
+            value /= 10;
+        } while (value != 0);
 
-        if (currentNode->lLink != NULL)
-            q.push(currentNode->lLink);
+        if (node->key < 0)
+            *--p = '-';
 
-        if (currentNode->rLink != NULL)
-            q.push(currentNode->rLink);
+        buffer.append(p, digits + sizeof(digits));
+        buffer += ' ';
+        buffer += node->info;
+        buffer += '\n';
 
+        /* Parents precede their children, so the output can be loaded back in order */
+        if (node->rLink != NULL)
+            pending.push_back(node->rLink);
 
-        output << currentNode->key << " " << currentNode->info << endl;
+        if (node->lLink != NULL)
+            pending.push_back(node->lLink);
     }
-    
+}
+
+bool QATree::WriteRecords(int fd) const
+{
+    vector<const StringNode*> pending;
+    string buffer;
+    size_t written;
+    long count;
+
+    buffer.reserve(SAVE_BLOCK_SIZE + 256);
+
+    if (root != NULL)
+        pending.push_back(root);
+
+    while (!pending.empty())
+    {
+        FormatRecords(pending, buffer);
+
+        for (written = 0; written < buffer.size(); written += (size_t) count)
+        {
+#ifdef _WIN32
+            count = _write(fd, buffer.data() + written, (unsigned int) (buffer.size() - written));
+#else
+            count = (long) write(fd, buffer.data() + written, buffer.size() - written);
+#endif
+
+            if (count < 0 && errno == EINTR)
+                count = 0;
+            else if (count <= 0)
+                return false;
+        }
+
+        buffer.clear();
+    }
+
+    return true;
+}
+
+ostream & operator <<(ostream & output, QATree & QA)
+{
+    vector<const StringNode*> pending;
+    string buffer;
+
+    buffer.reserve(SAVE_BLOCK_SIZE + 256);
+
+    if (QA.root != NULL)
+        pending.push_back(QA.root);
+
+    while (!pending.empty())
+    {
+        QA.FormatRecords(pending, buffer);
+        output.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
     return output;
 }
\ No newline at end of file
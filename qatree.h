@@ -2,8 +2,8 @@
  *  \brief Defines a question and answer decision tree.
  *
  *  \author  B. Jordan
- *  \version 6.0
- *  \date 19-MAY-2009
+ *  \version 31.0
+ *  \date 19-OCT-2026
  *
  * <pre>
  *  Revision  Name        Date         Description
@@ -14,6 +14,40 @@
  *  4         B. Jordan   14-MAY-2009  Added input
  *  5         B. Jordan   14-MAY-2009  Overloaded input operator
  *  6         B. Jordan   19-MAY-2009  Added GetFirstQA function
+ *  7         agent       18-OCT-2026  Added block-based LoadRecords function
+ *  8         agent       18-OCT-2026  Buffered preorder output operator
+ *  9         agent       19-OCT-2026  Added ClassifyBatch function
+ *  10        agent       19-OCT-2026  Added WriteCompiledTable function
+ *  11        agent       19-OCT-2026  Added shared pool constructor
+ *  12        agent       19-OCT-2026  Added LearnBatch function
+ *  13        agent       19-OCT-2026  Added ExplainPath function
+ *  14        agent       19-OCT-2026  Query functions no longer allocate
+ *  15        agent       19-OCT-2026  Added WriteImage function
+ *  16        agent       19-OCT-2026  Added optional visit counting
+ *  17        agent       19-OCT-2026  Added Merge function
+ *  18        agent       19-OCT-2026  Output written from an explicit stack.
+ *                                     Added WriteRecords for file descriptors
+ *  19        agent       19-OCT-2026  LearnBatch maps only the guesses named
+ *                                     by the batch
+ *  20        agent       19-OCT-2026  Visit counts saturate
+ *  21        agent       19-OCT-2026  Merge keeps questions learned by both
+ *                                     trees and merges below them
+ *  22        agent       19-OCT-2026  LearnBatch renumbers crowded keys
+ *                                     rather than scaling them
+ *  23        agent       19-OCT-2026  DEFAULT_SCALE moved to bsttype.h
+ *  24        agent       19-OCT-2026  ExplainPath walks down by key
+ *  25        agent       19-OCT-2026  QATreeForest may read nodes to park trees
+ *  26        agent       19-OCT-2026  Added key overloads of GetFirstQA,
+ *                                     GetNextQA and IsAnswer
+ *  27        agent       19-OCT-2026  Visit counting moved to BSTType
+ *  28        agent       19-OCT-2026  LoadRecords splits blocks through
+ *                                     LoadBlock, which QALoader shares
+ *  29        agent       19-OCT-2026  ClassifyBatch returns leaves over a
+ *                                     range of answer sets
+ *  30        agent       19-OCT-2026  Merge no longer compares common
+ *                                     subtrees before merging them
+ *  31        agent       19-OCT-2026  CreateQuestionAnswer renumbers crowded
+ *                                     keys rather than scaling them
  * </pre>
  */
 
@@ -23,15 +57,29 @@
 
 #include "bsttype.h"
 #include <string>
-#include <queue>
+#include <vector>
+#include <map>
+#include <set>
 
-const int DEFAULT_SCALE = 1;            // Defines the default node scale
 const int CORRECT_PATH = 1;             // Defines the correct (right) path
 const int INCORRECT_PATH = 0;           // Defines incorrect (left) path
+const int LOAD_BLOCK_SIZE = 1 << 20;    // Defines the read size used when loading
+const int SAVE_BLOCK_SIZE = 1 << 20;    // Defines the write size used when saving
+const int CLASSIFY_GROUP_SIZE = 16;     // Defines how many answer sets are walked together
 
 typedef NodeType<string> StringNode;	
 typedef BSTType<string> StringBST;
 
+/*! \struct QALearnRecord
+ *  \brief A question learned after the computer guessed wrongly.
+ */
+struct QALearnRecord
+{
+    string question;                    // The question distinguishing the answers
+    string answer;                      // The player's object (the yes answer)
+    string alternateQA;                 // The incorrect guess (the no answer)
+};
+
 class QATree : public StringBST
 {
 public:
@@ -39,10 +87,17 @@ public:
 	/*! Default constructor for QATree */
     QATree();
 
+	/*! Constructor for a QATree that allocates from a shared pool
+	 *  \param pool The pool to allocate nodes from. It must outlive the tree.
+	 */
+    QATree(NodePool<string> *pool);
+
 	/*! Default destructor for QATree */
     virtual ~QATree();
 
-    /*! Create a question or answer in the decision tree
+    /*! Create a question or answer in the decision tree. If the keys
+	 *  around any answer are too close to place new keys between them,
+	 *  every key is first renumbered, two apart, in key order.
 	 *  \retval true If the previous answer is found and a new answer is created.
      *  \retval false If the previous answer is not found and a new answer is not created.
      *  \param newQuestion The new question to be created.
@@ -52,14 +107,62 @@ public:
     bool CreateQuestionAnswer(string newQuestion, string newAnswer,
                               string alternateQA);
 
-    /*! Get the next question or answer in the tree
+	/*! Applies many learned questions in one pass. Every guess is resolved
+	 *  in a single walk of the tree, keys are renumbered at most once, and the
+	 *  new answers are linked directly below each guess. A record conflicts,
+	 *  and is not applied, if its guess is not found, is a question, or was
+	 *  already replaced by an earlier record in the same batch. If the tree
+	 *  is empty, the first record seeds it instead; both of its answers are
+	 *  new leaves, so later records in the batch may name either as a guess.
+	 *  \param records The questions to learn, applied in order.
+	 *  \retval conflicts The indexes of the records that were not applied.
+	 *  \retval count The number of records applied.
+	 */
+    int LearnBatch(const vector<QALearnRecord> &records, vector<int> &conflicts);
+
+	/*! Replaces this tree with a three-way merge of two trees that learned
+	 *  independently from a common base. The trees are walked in lockstep,
+	 *  and a subtree learned below a base answer by only one side is grafted
+	 *  onto that answer. Where both sides learned below the same answer,
+	 *  their subtrees are merged as far as they agree: a question both
+	 *  learned is kept once, and anything either side learned below it is
+	 *  merged in turn. Where they disagree, the first tree's subtree is kept
+	 *  and the text is reported as a conflict. A tree missing part of the
+	 *  base is also reported. The merged tree is renumbered in key order.
+	 *  \param base The common tree both sides learned from.
+	 *  \param first The first tree to merge.
+	 *  \param second The second tree to merge.
+	 *  \retval conflicts The texts where the trees could not be merged.
+	 *  \retval true If the trees merged without conflicts.
+	 *  \retval false If any conflicts were reported.
+	 */
+    bool Merge(const QATree &base, const QATree &first, const QATree &second,
+               vector<string> &conflicts);
+
+    /*! Get the next question or answer in the tree. The question is found
+	 *  by searching the whole tree for its text, so each call costs O(size);
+	 *  play should use the overload taking a key.
 	 *  \param question A string representing a question.
      *  \param qaPath Determines which questioning path to follow.
      *  \retval true If a correct answer is defined.
      *  \retval false If no correct answer is defined.
      *  \retval answer The predicted answer to a question
      */
-    bool GetNextQA(string question, string &answer, int qaPath);
+    bool GetNextQA(const string &question, string &answer, int qaPath);
+
+    /*! Get the next question or answer in the tree, walking down from the
+	 *  root by key, so that only the nodes on the path are touched. If the
+	 *  key no longer holds the question, because learning has renumbered
+	 *  the keys, the question is found by its text instead.
+	 *  \param question The current question.
+	 *  \param key The key of the current question. Set to the key of the
+	 *             answer returned.
+     *  \param qaPath Determines which questioning path to follow.
+     *  \retval true If a correct answer is defined.
+     *  \retval false If no correct answer is defined.
+     *  \retval answer The predicted answer to a question
+     */
+    bool GetNextQA(const string &question, int &key, string &answer, int qaPath);
     
 	/*! Get the first question in the tree
      *  \retval question The question string, if found.
@@ -68,18 +171,213 @@ public:
      */
     bool GetFirstQA(string &question);
 
+	/*! Get the first question in the tree, and its key
+     *  \retval question The question string, if found.
+     *  \retval key The key of the question, if found.
+     *  \retval false If root node has not been defined.
+     *  \retval true If root node has been returned successfully.
+     */
+    bool GetFirstQA(string &question, int &key);
+
 	/*! Return true if the text is found in the tree, and is an answer
 	 *  \param qaText The question or answer text to search for in the tree
 	 *	\retval true If the text is found, and is an answer
 	 *	\retval false If the text is not found or is not an answer 
 	 */
-    bool IsAnswer(string qaText);
+    bool IsAnswer(const string &qaText);
+
+	/*! Return true if a question or answer found by key is an answer. As
+	 *  with GetNextQA, the text is searched for only if the key no longer
+	 *  holds it.
+	 *  \param qaText The question or answer text
+	 *  \param key The key of the text
+	 *	\retval true If the text is found, and is an answer
+	 *	\retval false If the text is not found or is not an answer
+	 */
+    bool IsAnswer(const string &qaText, int key) const;
+
+	/*! Explains an answer by listing the questions leading to it from the root.
+	 *  Once the answer is found, the path is walked down from the root by
+	 *  key, in O(depth).
+	 *  \param answer The answer to explain.
+	 *  \retval questions The questions from the root down to the answer.
+	 *  \retval qaPaths The path taken below each question (CORRECT_PATH or
+	 *          INCORRECT_PATH).
+	 *  \retval true If the answer is found, and is an answer.
+	 *  \retval false If the answer is not found, or is a question.
+	 */
+    bool ExplainPath(const string &answer, vector<string> &questions,
+                     vector<int> &qaPaths) const;
+
+	/*! Classifies a range of pre-recorded answer sets against the tree.
+	 *  Each answer set is a string of y/n characters, one per question, starting
+	 *  at the root. Answer sets are walked in interleaved groups so that the
+	 *  node loads of one walk overlap with those of the others. Nothing is
+	 *  allocated or changed, so disjoint ranges of one batch may be classified
+	 *  on several threads at once while the tree is not being changed.
+	 *  \param answerSets The answer sets to classify.
+	 *  \param begin The index of the first answer set to classify.
+	 *  \param end The index one past the last answer set to classify.
+	 *  \param leaves Caller storage for one leaf per answer set. Only the
+	 *         entries from begin to end - 1 are written.
+	 *  \retval leaves The answer node reached by each answer set, or NULL if
+	 *          the set ran out, or held a character other than y or n, before
+	 *          an answer was reached. The text of a leaf is its info. Leaves
+	 *          stay valid until the tree is next changed or reclustered.
+	 *  \retval count The number of answer sets that reached an answer.
+	 */
+	int ClassifyBatch(const vector<string> &answerSets, size_t begin, size_t end,
+	                  const StringNode **leaves) const;
+
+	/*! Classifies every answer set, returning the text of each answer.
+	 *  \param answerSets The answer sets to classify.
+	 *  \retval answers The answer reached by each answer set, or an empty string
+	 *          if no answer was reached.
+	 *  \retval count The number of answer sets that reached an answer.
+	 */
+	int ClassifyBatch(const vector<string> &answerSets, vector<string> &answers) const;
+
+	/*! Reads every "key text" record from a stream and inserts it into the tree.
+	 *  The stream is consumed in large blocks and split into records in memory,
+	 *  rather than being parsed one character at a time.
+	 *  \param input The stream holding the tree records.
+	 */
+	void LoadRecords(istream &input);
+
+	/*! Writes every node to an open file descriptor as "key text" records,
+	 *  in the same format and order as the output operator, in large blocks.
+	 *  \param fd The file descriptor to write to.
+	 *  \retval true If every record was written.
+	 *  \retval false If a write failed.
+	 */
+	bool WriteRecords(int fd) const;
+
+	/*! Writes the tree as a static CompiledQANode table (see compiledtree.h).
+	 *  Nodes are numbered in preorder, so the root is always entry 0.
+	 *  \param output The stream receiving the generated C++ source.
+	 *  \param name The name of the generated table.
+	 */
+	void WriteCompiledTable(ostream &output, const string &name) const;
+
+	/*! Writes the tree as a flat binary image that QAImage can map read-only.
+	 *  Nodes are numbered in preorder, so the root is always node 0.
+	 *  \param output The binary stream receiving the image.
+	 */
+	void WriteImage(ostream &output) const;
 
     /*! Overriden input operator for a QATree object */
     friend istream & operator >>( istream & input, QATree & QA);
 	
     /*! Overriden output operator for a QATree object */
     friend ostream & operator <<( ostream & output, QATree & QA);
+
+    /*! Forests park trees by reading their nodes directly */
+    friend class QATreeForest;
+
+    /*! Loaders link the blocks their reader thread reads */
+    friend class QALoader;
+
+protected:
+
+	/*! Parses a single "key text" record and inserts it into the tree.
+	 *  Blank records and records without a key are ignored.
+	 *  \param first A pointer to the first character of the record.
+	 *  \param last A pointer one past the last character of the record.
+	 */
+	void InsertRecord(const char *first, const char *last);
+
+	/*! Splits a block of "key text" records and inserts each whole record
+	 *  into the tree. The partial record at the end of the block is kept
+	 *  and completed by the next block.
+	 *  \param first A pointer to the first character of the block.
+	 *  \param last A pointer one past the last character of the block.
+	 *  \param pending The partial record left by the previous block. On
+	 *         return, the partial record left by this block.
+	 */
+	void LoadBlock(const char *first, const char *last, string &pending);
+
+	/*! Returns the node holding a text, looked up by its key if the key
+	 *  still holds it, and otherwise searched for by text.
+	 *  \param qaText The question or answer text.
+	 *  \param key The key last known to hold the text.
+	 *  \retval node The node, or NULL if the text is not found.
+	 */
+	StringNode* LocateNode(const string &qaText, int key) const;
+
+	/*! Follows a question's link to the next question or answer, counting
+	 *  the visit if visits are counted.
+	 *  \param parent The question, or NULL if it was not found.
+	 *  \param qaPath Determines which questioning path to follow.
+	 *  \retval answer The next question or answer.
+	 *  \retval next The node followed to, if found.
+	 *  \retval true If a next question or answer is defined.
+	 *  \retval false If the question was not found or has no children.
+	 */
+	bool FollowQA(StringNode *parent, string &answer, StringNode* &next, int qaPath);
+
+	/*! Appends nodes to an output buffer in preorder, one "key text" record per
+	 *  line, until the buffer holds a block or every node has been written.
+	 *  An explicit stack is used, so the depth of the tree does not matter.
+	 *  \param pending The nodes still to be written, the next on top.
+	 *  \param buffer The output buffer.
+	 */
+	void FormatRecords(vector<const StringNode*> &pending, string &buffer) const;
+
+	/*! Numbers a subtree in preorder, appending each node to a list.
+	 *  \param node The root node of the subtree to number.
+	 *  \param nodes The nodes numbered so far.
+	 *  \param index The index assigned to each numbered node.
+	 */
+	void NumberNodes(const StringNode *node, vector<const StringNode*> &nodes,
+	                 map<const StringNode*, int> &index) const;
+
+	/*! Maps each target text to the first node holding it, in the same
+	 *  depth-first order that Search matches text in. Texts that are not
+	 *  targets are not copied, and the walk stops once every target is found.
+	 *  \param node The root node of the subtree to map.
+	 *  \param targets The texts to find.
+	 *  \param nodes The map of target text to nodes.
+	 */
+	void MapNodes(StringNode *node, const set<string> &targets,
+	              map<string, StringNode*> &nodes) const;
+
+	/*! Returns true if any two keys adjacent in key order are closer than 2,
+	 *  so that a new key could not be placed between them.
+	 *  \param node The root node of the subtree to check.
+	 *  \param previous The previous node in key order, or NULL.
+	 */
+	bool KeysCrowded(StringNode *node, StringNode* &previous) const;
+
+	/*! Merges three corresponding subtrees into a new subtree.
+	 *  \param base The subtree in the common tree.
+	 *  \param first The subtree in the first tree.
+	 *  \param second The subtree in the second tree.
+	 *  \param conflicts The conflicts reported so far.
+	 *  \retval node The root node of the merged subtree.
+	 */
+	StringNode* MergeNodes(StringNode *base, StringNode *first, StringNode *second,
+	                       vector<string> &conflicts);
+
+	/*! Merges two subtrees learned independently from the same answer, or
+	 *  from an empty tree, taking what they share as their common base.
+	 *  Each node of the two subtrees is visited once. Parts the two sides
+	 *  share are merged into a copy without conflicts, so they are not
+	 *  compared first.
+	 *  \param first The subtree in the first tree.
+	 *  \param second The subtree in the second tree.
+	 *  \param conflicts The conflicts reported so far.
+	 *  \retval node The root node of the merged subtree.
+	 */
+	StringNode* MergeCommon(StringNode *first, StringNode *second,
+	                        vector<string> &conflicts);
+
+	/*! Renumbers a subtree in key order, two apart so that learning can place
+	 *  new keys between them without scaling.
+	 *  \param node The root node of the subtree to renumber.
+	 *  \param key The next key to assign.
+	 *  \retval key The next key after the subtree.
+	 */
+	int NumberKeys(StringNode *node, int key);
 };
 
 